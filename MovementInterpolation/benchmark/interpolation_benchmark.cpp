@@ -0,0 +1,430 @@
+#include "movement_interpolation/core/interpolator.h"
+#include "movement_interpolation/core/interpolation_policy.h"
+#include "movement_interpolation/core/batch_interpolator.h"
+#include "movement_interpolation/core/frame_sampler.h"
+#include "movement_interpolation/core/ghost_trail.h"
+#include "movement_interpolation/core/skeleton.h"
+#include "movement_interpolation/core/pose_blender.h"
+#include "movement_interpolation/core/compressed_keyframe_track.h"
+#include "movement_interpolation/core/thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Microbenchmarks of the interpolation hot paths.
+ *
+ * Usage: MovementInterpolationBenchmark [--json file] [--min-time seconds]
+ * Prints ns/op and ops/s per benchmark, --json also writes them as
+ * machine readable output for comparing builds. Exits with 1 before
+ * timing anything if the batch kernels do not match Interpolator.
+ */
+
+namespace {
+
+template<class T>
+inline void DoNotOptimize(const T& value){
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchmarkResult {
+    std::string name;
+    // Operations done by a single call of the benchmark body.
+    double ops_per_call;
+    unsigned long long calls;
+    double seconds;
+
+    double ns_per_op() const {return seconds * 1e9 / (calls * ops_per_call);}
+    double ops_per_second() const {return calls * ops_per_call / seconds;}
+};
+
+BenchmarkResult Run(const std::string& name, double ops_per_call,
+                    double min_time, const std::function<void()>& body){
+    typedef std::chrono::steady_clock clock;
+    body();
+
+    unsigned long long calls = 0;
+    unsigned long long batch = 1;
+    double seconds = 0.0;
+    while(seconds < min_time){
+        auto start = clock::now();
+        for(unsigned long long i = 0; i < batch; i++)
+            body();
+        std::chrono::duration<double> elapsed = clock::now() - start;
+        seconds += elapsed.count();
+        calls += batch;
+        if(elapsed.count() < min_time / 10)
+            batch *= 2;
+    }
+    BenchmarkResult result;
+    result.name = name;
+    result.ops_per_call = ops_per_call;
+    result.calls = calls;
+    result.seconds = seconds;
+    std::printf("%-40s %12.2f ns/op %14.0f ops/s\n", name.c_str(),
+                result.ns_per_op(), result.ops_per_second());
+    return result;
+}
+
+InterpolationData CreateData(InterpolationMethod method){
+    InterpolationData data;
+    data.position_begin = glm::vec3(0,0,0);
+    data.position_end = glm::vec3(2,2,2);
+    data.euler_begin = glm::vec3(0,0,0);
+    data.euler_end = glm::vec3(67,20,270);
+    data.quaternion_begin = glm::normalize(
+            glm::quat(glm::radians(data.euler_begin)));
+    data.quaternion_end = glm::normalize(
+            glm::quat(glm::radians(data.euler_end)));
+    data.interpolation_method = method;
+    return data;
+}
+
+const char* MethodName(InterpolationMethod method){
+    switch(method){
+        case InterpolationMethod::LERP:
+            return "lerp";
+        case InterpolationMethod::SLERP:
+            return "slerp";
+        case InterpolationMethod::FAST_SLERP:
+            return "fast_slerp";
+    }
+    return "unknown";
+}
+
+// Same loop as InterpolateQuaternion/<method>, dispatched once.
+struct QuaternionLoop {
+    QuaternionLoop(const std::vector<float>& ts) : ts(ts){}
+
+    template<class Kernel>
+    void operator()(const Kernel& kernel) const {
+        for(float t : ts)
+            DoNotOptimize(kernel.Quaternion(t));
+    }
+
+    const std::vector<float>& ts;
+};
+
+/**
+ * Compares every compiled BatchInterpolator kernel with Interpolator on
+ * random tracks and t, false if a quaternion component differs by more
+ * than the 1e-5 the header promises.
+ */
+bool CheckBatchKernels(){
+    const int kTracks = 4096;
+    const float kTolerance = 1e-5f;
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> angle(-360.0f, 360.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    InterpolationMethod methods[] = {InterpolationMethod::LERP,
+                                     InterpolationMethod::SLERP,
+                                     InterpolationMethod::FAST_SLERP};
+    BatchInterpolator batch;
+    std::vector<Interpolator> interpolators;
+    std::vector<float> ts(kTracks);
+    for(int i = 0; i < kTracks; i++){
+        InterpolationData data = CreateData(methods[i % 3]);
+        data.euler_begin = glm::vec3(angle(random), angle(random),
+                                     angle(random));
+        data.euler_end = glm::vec3(angle(random), angle(random),
+                                   angle(random));
+        data.quaternion_begin = glm::normalize(
+                glm::quat(glm::radians(data.euler_begin)));
+        data.quaternion_end = glm::normalize(
+                glm::quat(glm::radians(data.euler_end)));
+        batch.AddTrack(data);
+        interpolators.push_back(Interpolator(data));
+        ts[i] = unit(random);
+    }
+
+    bool success = true;
+    BatchPoses poses;
+    BatchKernel kernels[] = {BatchKernel::SCALAR, BatchKernel::SSE,
+                             BatchKernel::AVX};
+    for(BatchKernel kernel : kernels){
+        batch.kernel(kernel);
+        if(batch.kernel() != kernel)
+            continue;
+        batch.Evaluate(ts.data(), poses);
+        float max_error = 0.0f;
+        for(int i = 0; i < kTracks; i++){
+            glm::quat expected = interpolators[i].InterpolateQuaternion(ts[i]);
+            glm::quat actual = poses.Quaternion(i);
+            for(int c = 0; c < 4; c++)
+                max_error = std::max(max_error,
+                                     std::abs(actual[c] - expected[c]));
+        }
+        std::printf("BatchInterpolator/%s max quaternion error %g\n",
+                    BatchInterpolator::KernelName(kernel), max_error);
+        if(!(max_error <= kTolerance))
+            success = false;
+    }
+    return success;
+}
+
+bool WriteJson(const std::string& path,
+               const std::vector<BenchmarkResult>& results){
+    FILE* file = std::fopen(path.c_str(), "w");
+    if(!file)
+        return false;
+    std::fprintf(file, "{\n  \"kernel\": \"%s\",\n  \"benchmarks\": [\n",
+                 BatchInterpolator::KernelName(
+                         BatchInterpolator::BestKernel()));
+    for(size_t i = 0; i < results.size(); i++){
+        const BenchmarkResult& result = results[i];
+        std::fprintf(file,
+                     "    {\"name\": \"%s\", \"ns_per_op\": %.4f, "
+                     "\"ops_per_second\": %.1f, \"iterations\": %llu}%s\n",
+                     result.name.c_str(), result.ns_per_op(),
+                     result.ops_per_second(),
+                     (unsigned long long)(result.calls * result.ops_per_call),
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    std::fclose(file);
+    return true;
+}
+
+}
+
+int main(int argc, char** argv){
+    std::string json_path;
+    double min_time = 0.25;
+    for(int i = 1; i < argc; i++){
+        if(std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_path = argv[++i];
+        else if(std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            min_time = std::atof(argv[++i]);
+        else{
+            std::printf("Usage: %s [--json file] [--min-time seconds]\n",
+                        argv[0]);
+            return 1;
+        }
+    }
+
+    if(!CheckBatchKernels()){
+        std::printf("BatchInterpolator does not match Interpolator\n");
+        return 1;
+    }
+
+    const int kSamples = 1024;
+    std::vector<float> ts(kSamples);
+    for(int i = 0; i < kSamples; i++)
+        ts[i] = (float)i / (float)(kSamples - 1);
+
+    std::vector<BenchmarkResult> results;
+    Interpolator interpolator(CreateData(InterpolationMethod::SLERP));
+
+    results.push_back(Run("InterpolatePosition", kSamples, min_time, [&](){
+        for(float t : ts)
+            DoNotOptimize(interpolator.InterpolatePosition(t));
+    }));
+    results.push_back(Run("InterpolateEulerAngles", kSamples, min_time, [&](){
+        for(float t : ts)
+            DoNotOptimize(interpolator.InterpolateEulerAngles(t));
+    }));
+
+    InterpolationMethod methods[] = {InterpolationMethod::LERP,
+                                     InterpolationMethod::SLERP,
+                                     InterpolationMethod::FAST_SLERP};
+    for(InterpolationMethod method : methods){
+        Interpolator method_interpolator(CreateData(method));
+        std::string name = std::string("InterpolateQuaternion/")
+                           + MethodName(method);
+        results.push_back(Run(name, kSamples, min_time, [&](){
+            for(float t : ts)
+                DoNotOptimize(method_interpolator.InterpolateQuaternion(t));
+        }));
+        results.push_back(Run(std::string("InterpolationKernel/")
+                              + MethodName(method), kSamples, min_time,
+                              [&](){
+            DispatchInterpolation(method_interpolator, QuaternionLoop(ts));
+        }));
+    }
+
+    std::vector<glm::quat> quaternions(kSamples);
+    for(int i = 0; i < kSamples; i++)
+        quaternions[i] = interpolator.InterpolateQuaternion(ts[i]);
+    results.push_back(Run("QuaternionToEulerDegrees", kSamples, min_time,
+                          [&](){
+        for(const glm::quat& q : quaternions)
+            DoNotOptimize(QuaternionToEulerDegrees(q));
+    }));
+
+    const int kTracks = 16384;
+    BatchInterpolator batch;
+    for(int i = 0; i < kTracks; i++)
+        batch.AddTrack(CreateData(methods[i % 3]));
+    BatchPoses poses;
+    BatchKernel kernels[] = {BatchKernel::SCALAR, BatchKernel::SSE,
+                             BatchKernel::AVX};
+    for(BatchKernel kernel : kernels){
+        batch.kernel(kernel);
+        if(batch.kernel() != kernel)
+            continue;
+        std::string name = std::string("BatchInterpolator/")
+                           + BatchInterpolator::KernelName(kernel);
+        float t = 0.0f;
+        results.push_back(Run(name, kTracks, min_time, [&](){
+            batch.Evaluate(t, poses);
+            t = t < 1.0f ? t + 0.01f : 0.0f;
+            DoNotOptimize(poses.quaternion_w[0]);
+        }));
+    }
+
+    // A chain of joints played back like InterpolationSimulation does,
+    // every joint rotated a little further.
+    const int kJoints = 200;
+    const int kJointKeys = 120;
+    auto skeleton = std::make_shared<Skeleton>();
+    std::vector<std::shared_ptr<KeyframeTrack>> joint_tracks;
+    for(int i = 0; i < kJoints; i++){
+        skeleton->AddJoint(std::to_string(i), i - 1);
+        auto joint_track = std::make_shared<KeyframeTrack>();
+        joint_track->interpolation_method(KeyframeInterpolationMethod::SLERP);
+        for(int k = 0; k < kJointKeys; k++){
+            Keyframe key;
+            key.time = (float)k / kJointKeys;
+            key.position = glm::vec3(0, 0.1f, 0);
+            key.rotation = glm::quat(glm::radians(
+                    glm::vec3(0, 0, (float)((i + k) % 30))));
+            joint_track->AddKey(key);
+        }
+        joint_tracks.push_back(joint_track);
+    }
+    SkeletonTrack skeleton_track;
+    skeleton_track.Set(skeleton, joint_tracks);
+    SkeletonPose skeleton_local;
+    SkeletonPose skeleton_world;
+    float skeleton_time = 0.0f;
+    results.push_back(Run("SkeletonTrack", kJoints, min_time, [&](){
+        skeleton_track.Evaluate(skeleton_time, skeleton_local,
+                                skeleton_world);
+        skeleton_time = skeleton_time < skeleton_track.duration()
+                        ? skeleton_time + 1.0f / 60.0f : 0.0f;
+        DoNotOptimize(skeleton_world.rotations[kJoints - 1]);
+    }));
+
+    const int kBlendInputs = 4;
+    PoseBlender pose_blender;
+    pose_blender.Resize(kBlendInputs, kSamples);
+    for(int i = 0; i < kBlendInputs; i++){
+        Interpolator input_interpolator(CreateData(methods[i % 3]));
+        for(int j = 0; j < kSamples; j++){
+            float t = (ts[j] + (float)i / kBlendInputs) * 0.5f;
+            pose_blender.input(i)[j] = input_interpolator.InterpolatePose(t);
+        }
+        pose_blender.weight(i, 1.0f + (float)i);
+    }
+    std::vector<Pose> blended(kSamples);
+    results.push_back(Run("PoseBlender/" + std::to_string(kBlendInputs),
+                          kSamples, min_time, [&](){
+        pose_blender.Blend(blended.data());
+        DoNotOptimize(blended[0].rotation);
+    }));
+
+    // Forward playback of many tracks, raw keys against compressed keys.
+    const int kKeyframeTracks = 4096;
+    const int kKeysPerTrack = 256;
+    std::vector<KeyframeTrack> keyframe_tracks(kKeyframeTracks);
+    for(int i = 0; i < kKeyframeTracks; i++){
+        Interpolator track_interpolator(CreateData(methods[i % 3]));
+        keyframe_tracks[i].Reserve(kKeysPerTrack);
+        for(int j = 0; j < kKeysPerTrack; j++){
+            Keyframe key;
+            key.time = (float)j / 30.0f;
+            Pose pose = track_interpolator.InterpolatePose(
+                    (float)j / (kKeysPerTrack - 1));
+            key.position = pose.position;
+            key.rotation = pose.rotation;
+            keyframe_tracks[i].AddKey(key);
+        }
+    }
+    KeyframeCompression compressions[] = {KeyframeCompression::HIGH,
+                                          KeyframeCompression::LOW};
+    float track_duration = keyframe_tracks[0].duration();
+    float track_time = 0.0f;
+    results.push_back(Run("KeyframeTrack::Evaluate", kKeyframeTracks,
+                          min_time, [&](){
+        glm::vec3 position;
+        glm::quat rotation;
+        for(const KeyframeTrack& track : keyframe_tracks)
+            track.Evaluate(track_time, position, rotation);
+        DoNotOptimize(rotation);
+        track_time = track_time < track_duration ? track_time + 0.01f : 0.0f;
+    }));
+    for(KeyframeCompression compression : compressions){
+        std::vector<CompressedKeyframeTrack> compressed(kKeyframeTracks);
+        for(int i = 0; i < kKeyframeTracks; i++)
+            compressed[i].Compress(keyframe_tracks[i], compression);
+        std::string name = std::string("CompressedKeyframeTrack::Evaluate/")
+                + (compression == KeyframeCompression::HIGH ? "high" : "low");
+        track_time = 0.0f;
+        results.push_back(Run(name, kKeyframeTracks, min_time, [&](){
+            glm::vec3 position;
+            glm::quat rotation;
+            for(const CompressedKeyframeTrack& track : compressed)
+                track.Evaluate(track_time, position, rotation);
+            DoNotOptimize(rotation);
+            track_time = track_time < track_duration
+                         ? track_time + 0.01f : 0.0f;
+        }));
+    }
+
+    // SimulateFrames without the scene: sampling stage and ghost trail.
+    ThreadPool thread_pool;
+    FrameSamples samples;
+    GhostTrail ghost_trail;
+    int frame_counts[] = {1000, 10000, 100000};
+    for(int count : frame_counts){
+        std::string suffix = "/" + std::to_string(count);
+        results.push_back(Run("SimulateFrames/serial" + suffix, count,
+                              min_time, [&](){
+            FrameSampler::Sample(interpolator, count, samples);
+            DoNotOptimize(samples.quaternions[0]);
+        }));
+        results.push_back(Run("SimulateFrames/parallel" + suffix, count,
+                              min_time, [&](){
+            FrameSampler::Sample(interpolator, count, samples, &thread_pool);
+            DoNotOptimize(samples.quaternions[0]);
+        }));
+        results.push_back(Run("SimulateFrames/incremental" + suffix, count,
+                              min_time, [&](){
+            FrameSampler::Sample(interpolator, count, samples, nullptr,
+                                 FrameSamplingMode::INCREMENTAL);
+            DoNotOptimize(samples.quaternions[0]);
+        }));
+        results.push_back(Run("GhostTrail::Build" + suffix, count,
+                              min_time, [&](){
+            ghost_trail.Build(samples);
+            DoNotOptimize(ghost_trail.data()[0]);
+        }));
+    }
+
+    // One op is a whole adaptive sampling of the path.
+    results.push_back(Run("SimulateFrames/adaptive", 1, min_time, [&](){
+        FrameSampler::SampleAdaptive(interpolator, 100000,
+                                     AdaptiveTolerance(), samples);
+        DoNotOptimize(samples.quaternions[0]);
+    }));
+
+    if(!json_path.empty() && !WriteJson(json_path, results)){
+        std::printf("Could not write %s\n", json_path.c_str());
+        return 1;
+    }
+    return 0;
+}
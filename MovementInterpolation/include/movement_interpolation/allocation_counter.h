@@ -0,0 +1,12 @@
+#ifndef PROJECT_ALLOCATION_COUNTER_H
+#define PROJECT_ALLOCATION_COUNTER_H
+
+/**
+ * Number of operator new calls on all threads since the start.
+ *
+ * Counting replaces the global operator new and delete of the
+ * application, the core library and the tools keep the default ones.
+ */
+unsigned long long AllocationCount();
+
+#endif //PROJECT_ALLOCATION_COUNTER_H
@@ -0,0 +1,127 @@
+#ifndef PROJECT_BATCH_INTERPOLATOR_H
+#define PROJECT_BATCH_INTERPOLATOR_H
+
+#include "movement_interpolation/core/interpolation_data.h"
+
+#include <vector>
+#include <cstddef>
+
+enum class BatchKernel {
+    SCALAR, SSE, AVX
+};
+
+/**
+ * Structure of arrays output of BatchInterpolator, one entry per track.
+ */
+struct BatchPoses {
+    std::vector<float> position_x;
+    std::vector<float> position_y;
+    std::vector<float> position_z;
+
+    std::vector<float> euler_x;
+    std::vector<float> euler_y;
+    std::vector<float> euler_z;
+
+    std::vector<float> quaternion_w;
+    std::vector<float> quaternion_x;
+    std::vector<float> quaternion_y;
+    std::vector<float> quaternion_z;
+
+    void Resize(size_t count);
+    size_t size() const {return position_x.size();}
+
+    glm::vec3 Position(size_t i) const;
+    glm::vec3 EulerAngles(size_t i) const;
+    glm::quat Quaternion(size_t i) const;
+};
+
+/**
+ * Evaluates many independent InterpolationData tracks at once.
+ * Tracks are stored as structure of arrays and the per track SLERP
+ * constants are computed once in AddTrack.
+ *
+ * Results match Interpolator within 1e-5 per quaternion component
+ * (sin is evaluated with a polynomial that is exact to ~6e-8 on the
+ * [0, pi/2] range SLERP needs). Positions and Euler angles use the same
+ * formula as Interpolator. FAST_SLERP tracks use the same t remapping
+ * as Interpolator. Positions of tracks with a position_path are
+ * evaluated on their path after the kernel.
+ */
+class BatchInterpolator {
+public:
+    BatchInterpolator();
+    ~BatchInterpolator();
+
+    size_t size() const {return method_.size();}
+
+    BatchKernel kernel() const {return kernel_;}
+    /**
+     * Falls back to the best compiled kernel if the requested one
+     * was not compiled in.
+     */
+    void kernel(BatchKernel kernel);
+    static BatchKernel BestKernel();
+    static const char* KernelName(BatchKernel kernel);
+
+    void Reserve(size_t count);
+    void Clear();
+    size_t AddTrack(const InterpolationData& data);
+
+    /**
+     * Evaluates all tracks at the same t.
+     */
+    void Evaluate(float t, BatchPoses& poses) const;
+    /**
+     * Evaluates track i at t[i], t must hold size() values.
+     */
+    void Evaluate(const float* t, BatchPoses& poses) const;
+
+private:
+    void Evaluate(const float* t, bool uniform_t, BatchPoses& poses) const;
+
+    template<class F>
+    void ForEachStream(F f);
+
+    BatchKernel kernel_;
+
+    std::vector<InterpolationMethod> method_;
+
+    std::vector<float> position_begin_x_;
+    std::vector<float> position_begin_y_;
+    std::vector<float> position_begin_z_;
+    std::vector<float> position_delta_x_;
+    std::vector<float> position_delta_y_;
+    std::vector<float> position_delta_z_;
+
+    std::vector<float> euler_begin_x_;
+    std::vector<float> euler_begin_y_;
+    std::vector<float> euler_begin_z_;
+    std::vector<float> euler_delta_x_;
+    std::vector<float> euler_delta_y_;
+    std::vector<float> euler_delta_z_;
+
+    std::vector<float> quaternion_begin_w_;
+    std::vector<float> quaternion_begin_x_;
+    std::vector<float> quaternion_begin_y_;
+    std::vector<float> quaternion_begin_z_;
+    // Already flipped to the shortest path for SLERP tracks.
+    std::vector<float> quaternion_end_w_;
+    std::vector<float> quaternion_end_x_;
+    std::vector<float> quaternion_end_y_;
+    std::vector<float> quaternion_end_z_;
+
+    std::vector<float> theta_;
+    std::vector<float> inv_sin_theta_;
+    // 1 if the track uses the SLERP weights, 0 for linear weights.
+    std::vector<float> use_slerp_;
+    // 1 if linear weights use the FAST_SLERP remapped t.
+    std::vector<float> use_fast_slerp_;
+    std::vector<float> fast_slerp_a_;
+    std::vector<float> fast_slerp_b_;
+
+    // Tracks following a SplinePath, usually few.
+    std::vector<size_t> path_tracks_;
+    std::vector<std::shared_ptr<const SplinePath>> paths_;
+};
+
+#endif //PROJECT_BATCH_INTERPOLATOR_H
@@ -0,0 +1,65 @@
+#ifndef PROJECT_BATCH_JOB_H
+#define PROJECT_BATCH_JOB_H
+
+#include "movement_interpolation/core/interpolation_data.h"
+#include "movement_interpolation/core/frame_sampler.h"
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * Largest frame count of a job, bounds the samples a job allocates.
+ */
+const int kMaxBatchJobFrames = 1 << 20;
+
+/**
+ * One configuration of a parameter sweep, sampled like SimulateFrames.
+ */
+struct BatchJob {
+    InterpolationSimulationCreateParam param;
+    int frames_count;
+};
+
+/**
+ * Angle between the rotation of the Euler path and the quaternion path
+ * over the sampled frames, in degrees.
+ */
+struct DivergenceStats {
+    float mean_degrees;
+    float rms_degrees;
+    float max_degrees;
+    // Time of max_degrees in seconds.
+    float max_time;
+};
+
+/**
+ * One job per line, whitespace separated:
+ *   method length frames
+ *   position_begin xyz position_end xyz
+ *   euler_begin xyz euler_end xyz (degrees)
+ *   [quaternion_begin wxyz quaternion_end wxyz]
+ * method is lerp, slerp or fast_slerp. frames is at most
+ * kMaxBatchJobFrames. Without quaternions they are computed from the
+ * Euler angles like the GUI does.
+ */
+bool ParseBatchJob(const std::string& line, BatchJob& job,
+                   std::string& error);
+
+/**
+ * Appends up to max_count jobs of input to jobs, fewer only at the end
+ * of input. Empty lines and lines starting with # are skipped.
+ * line_number counts the lines read so far, for errors.
+ */
+bool ReadBatchJobs(std::istream& input, size_t max_count,
+                   std::vector<BatchJob>& jobs, size_t& line_number,
+                   std::string& error);
+
+/**
+ * Samples the frames of job into samples, reusing their storage, and
+ * compares the two rotation paths.
+ */
+DivergenceStats RunBatchJob(const BatchJob& job, FrameSamples& samples);
+
+#endif //PROJECT_BATCH_JOB_H
@@ -0,0 +1,19 @@
+#ifndef PROJECT_BVH_LOADER_H
+#define PROJECT_BVH_LOADER_H
+
+#include "movement_interpolation/core/keyframe_file.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Reads a BVH motion capture file into one track per joint, holding the
+ * joint transform relative to its parent at every frame: joint offset
+ * plus position channels, rotation channels composed in file order.
+ * Positions are in file units.
+ */
+bool LoadBvh(const std::string& path,
+             std::vector<NamedKeyframeTrack>& tracks,
+             std::string& error);
+
+#endif //PROJECT_BVH_LOADER_H
@@ -0,0 +1,46 @@
+#ifndef PROJECT_CLOCK_H
+#define PROJECT_CLOCK_H
+
+#include <chrono>
+
+/**
+ * Source of time in seconds for the simulation.
+ */
+class Clock {
+public:
+    virtual ~Clock(){}
+
+    virtual double Now() = 0;
+};
+
+/**
+ * Monotonic real time, measured from construction.
+ */
+class WallClock : public Clock {
+public:
+    WallClock();
+    ~WallClock();
+
+    double Now() override;
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Virtual time that only moves when told to. Used to replay a simulation
+ * deterministically or faster than real time.
+ */
+class ManualClock : public Clock {
+public:
+    ManualClock(double time = 0.0);
+    ~ManualClock();
+
+    double Now() override {return time_;}
+
+    void Set(double time){time_ = time;}
+    void Advance(double delta){time_ += delta;}
+private:
+    double time_;
+};
+
+#endif //PROJECT_CLOCK_H
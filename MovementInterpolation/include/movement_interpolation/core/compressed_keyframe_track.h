@@ -0,0 +1,110 @@
+#ifndef PROJECT_COMPRESSED_KEYFRAME_TRACK_H
+#define PROJECT_COMPRESSED_KEYFRAME_TRACK_H
+
+#include "movement_interpolation/core/keyframe_track.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Bits per key of the rotations and positions.
+ *   HIGH: 48 bit smallest three rotations, 16 bits per position axis.
+ *   LOW:  32 bit smallest three rotations, 11/11/10 bit positions.
+ */
+enum class KeyframeCompression {
+    HIGH, LOW
+};
+
+/**
+ * Largest difference between the decoded and the source keys.
+ */
+struct CompressionError {
+    float time;
+    float position;
+    float angle_degrees;
+};
+
+/**
+ * Read only KeyframeTrack with quantized keys, decoded on the fly.
+ *
+ * Keys are split into blocks of kBlockSize keys. Every block header
+ * stores the time base and the position range of its keys, positions are
+ * quantized within that range. Rotations are stored as their three
+ * smallest components plus the index of the dropped one.
+ *
+ * A block leaves out the key times when they are evenly spaced and the
+ * positions when they are constant, the common case for sampled motion
+ * capture and for joints that only rotate.
+ *
+ * Like KeyframeTrack it remembers the last segment, so a single track
+ * must not be evaluated from several threads at once. SQUAD tracks are
+ * evaluated with SLERP. Decoded rotations lose their sign, so LERP
+ * always takes the shorter arc.
+ */
+class CompressedKeyframeTrack {
+public:
+    static const size_t kBlockSize = 64;
+
+    CompressedKeyframeTrack();
+    ~CompressedKeyframeTrack();
+
+    void Compress(const KeyframeTrack& track,
+                  KeyframeCompression compression);
+    void Decompress(KeyframeTrack& track) const;
+
+    KeyframeCompression compression() const {return compression_;}
+    KeyframeInterpolationMethod interpolation_method() const {
+        return interpolation_method_;}
+
+    size_t size() const {return size_;}
+    float start_time() const;
+    float end_time() const;
+    float duration() const {return end_time() - start_time();}
+
+    /**
+     * Memory of the block headers and the key data.
+     */
+    size_t size_bytes() const;
+
+    Keyframe key(size_t index) const;
+    float key_time(size_t index) const;
+
+    void Evaluate(float time, glm::vec3& position, glm::quat& rotation) const;
+
+    CompressionError MeasureError(const KeyframeTrack& track) const;
+
+private:
+    static const uint32_t kOmitted = 0xFFFFFFFF;
+
+    struct Block {
+        float time_begin;
+        // Time between keys if evenly spaced, else per quantization step.
+        float time_scale;
+        glm::vec3 position_min;
+        // Per quantization step, zero for constant positions.
+        glm::vec3 position_scale;
+        // Byte offsets into data_, kOmitted when left out.
+        uint32_t times_offset;
+        uint32_t positions_offset;
+        uint32_t rotations_offset;
+    };
+
+    const Block* blocks() const {
+        return reinterpret_cast<const Block*>(data_.data());}
+    size_t FindSegment(float time) const;
+    glm::vec3 DecodePosition(const Block& block, size_t index) const;
+    glm::quat DecodeRotation(const Block& block, size_t index) const;
+
+    KeyframeCompression compression_;
+    KeyframeInterpolationMethod interpolation_method_;
+    size_t size_;
+
+    // Block headers, then per block: times (uint16), positions and
+    // rotations, each 4 byte aligned. One allocation per track.
+    std::vector<uint8_t> data_;
+
+    mutable size_t cursor_;
+};
+
+#endif //PROJECT_COMPRESSED_KEYFRAME_TRACK_H
@@ -0,0 +1,51 @@
+#ifndef PROJECT_FIXED_STEP_SCHEDULER_H
+#define PROJECT_FIXED_STEP_SCHEDULER_H
+
+/**
+ * Fixed timestep accumulator.
+ * Elapsed time is accumulated and consumed in whole steps, the remainder
+ * is carried over to the next Advance. At most max_substeps are run per
+ * Advance, time beyond that is dropped so a stall can not spiral.
+ */
+class FixedStepScheduler {
+public:
+    FixedStepScheduler(double step, int max_substeps = 8);
+    ~FixedStepScheduler();
+
+    double step() const {return step_;}
+    int max_substeps() const {return max_substeps_;}
+    void max_substeps(int value){max_substeps_ = value;}
+
+    double accumulator() const {return accumulator_;}
+    /**
+     * Fraction of a step left in the accumulator, in [0, 1).
+     * Used to render between the previous and the current step.
+     */
+    double alpha() const {return accumulator_ / step_;}
+
+    unsigned long long steps_taken() const {return steps_taken_;}
+    unsigned long long steps_dropped() const {return steps_dropped_;}
+
+    /**
+     * Restarts measuring from now, clears the accumulator.
+     */
+    void Reset(double now);
+
+    /**
+     * Returns the number of steps to run for the time elapsed since
+     * the last call.
+     */
+    int Advance(double now);
+
+private:
+    double step_;
+    int max_substeps_;
+
+    double last_time_;
+    double accumulator_;
+
+    unsigned long long steps_taken_;
+    unsigned long long steps_dropped_;
+};
+
+#endif //PROJECT_FIXED_STEP_SCHEDULER_H
@@ -0,0 +1,112 @@
+#ifndef PROJECT_FRAME_SAMPLER_H
+#define PROJECT_FRAME_SAMPLER_H
+
+#include "movement_interpolation/core/interpolator.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+enum class FrameSamplingMode {
+    // Every frame evaluates the interpolation method.
+    EXACT,
+    // SLERP frames advance by a constant delta rotation, one quaternion
+    // multiply per frame and an exact SLERP every 256 frames, within
+    // 1e-4 rad of EXACT. Other methods sample exactly.
+    INCREMENTAL,
+    // As few frames as needed to follow both paths within an
+    // AdaptiveTolerance, count is the upper bound.
+    ADAPTIVE
+};
+
+/**
+ * Largest deviation allowed between the paths and the poses linearly
+ * interpolated (slerped) between two consecutive ADAPTIVE frames.
+ */
+struct AdaptiveTolerance {
+    float position = 0.01f;
+    float angle_degrees = 1.0f;
+};
+
+/**
+ * Poses of both interpolation paths at t = i / count, or at the times
+ * chosen by ADAPTIVE sampling.
+ */
+struct FrameSamples {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> euler_angles;
+    std::vector<glm::quat> quaternions;
+
+    void Resize(size_t count);
+    size_t size() const {return positions.size();}
+};
+
+/**
+ * Samples frames of an Interpolator on a ThreadPool without blocking the
+ * caller. Poll IsDone and take the result with TakeSamples.
+ */
+class FrameSampler {
+public:
+    FrameSampler(std::shared_ptr<ThreadPool> thread_pool);
+    ~FrameSampler();
+
+    /**
+     * Cancels the running job, if any, and starts a new one.
+     */
+    void Start(const Interpolator& interpolator, int count,
+               FrameSamplingMode mode = FrameSamplingMode::EXACT,
+               const AdaptiveTolerance& tolerance = AdaptiveTolerance());
+    void Cancel();
+
+    bool IsRunning() const;
+    bool IsDone() const;
+    /**
+     * Fraction of sampled frames in [0, 1].
+     */
+    float progress() const;
+
+    /**
+     * Moves the finished samples out, false if the job is not done.
+     */
+    bool TakeSamples(FrameSamples& samples);
+    /**
+     * Hands samples back once consumed, the next Start reuses their storage.
+     */
+    void Recycle(FrameSamples&& samples);
+
+    /**
+     * Blocking version, used when there is nothing to keep responsive.
+     */
+    static void Sample(const Interpolator& interpolator, int count,
+                       FrameSamples& samples,
+                       ThreadPool* thread_pool = nullptr,
+                       FrameSamplingMode mode = FrameSamplingMode::EXACT,
+                       const AdaptiveTolerance& tolerance
+                               = AdaptiveTolerance());
+
+    /**
+     * Refines the segment with the largest error until every segment is
+     * within tolerance or max_count frames are used, both ends included.
+     */
+    static void SampleAdaptive(const Interpolator& interpolator,
+                               int max_count,
+                               const AdaptiveTolerance& tolerance,
+                               FrameSamples& samples,
+                               const std::atomic<bool>* cancelled = nullptr);
+
+private:
+    struct Job;
+
+    static void SampleRange(const Interpolator& interpolator, int count,
+                            FrameSamplingMode mode,
+                            size_t begin, size_t end,
+                            FrameSamples& samples);
+
+    std::shared_ptr<ThreadPool> thread_pool_;
+    std::shared_ptr<Job> job_;
+    FrameSamples spare_samples_;
+};
+
+#endif //PROJECT_FRAME_SAMPLER_H
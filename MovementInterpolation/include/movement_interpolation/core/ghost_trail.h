@@ -0,0 +1,68 @@
+#ifndef PROJECT_GHOST_TRAIL_H
+#define PROJECT_GHOST_TRAIL_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <cstddef>
+
+struct FrameSamples;
+struct SkeletonPose;
+
+/**
+ * Transform of a single ghost, laid out for direct upload as per instance
+ * vertex attributes: position (w unused) and rotation as x, y, z, w.
+ */
+struct GhostInstance {
+    float position[4];
+    float rotation[4];
+};
+
+/**
+ * Contiguous instance buffer of the frames produced by SimulateFrames.
+ * The Euler path ghosts come first, followed by the quaternion path
+ * ghosts, so the whole trail is drawn with one instanced call.
+ *
+ * A trail lives as long as its owner and is rebuilt in place: Clear is
+ * O(1) and keeps the storage for the next Build.
+ */
+class GhostTrail {
+public:
+    GhostTrail();
+    ~GhostTrail();
+
+    const GhostInstance* data() const {return instances_.data();}
+    size_t size() const {return instances_.size();}
+    size_t euler_count() const {return euler_count_;}
+    size_t quaternion_count() const {return size() - euler_count_;}
+    size_t size_bytes() const {return size() * sizeof(GhostInstance);}
+    size_t capacity_bytes() const {
+        return instances_.capacity() * sizeof(GhostInstance);}
+
+    /**
+     * Incremented on every change, lets GPU copies detect stale data.
+     */
+    unsigned long long revision() const {return revision_;}
+
+    void Build(const FrameSamples& samples);
+    /**
+     * One instance per joint of a world pose, all counted as quaternion
+     * ghosts.
+     */
+    void Build(const SkeletonPose& pose);
+    void Clear();
+    /**
+     * Frees the storage, for when a large trail will not be rebuilt.
+     */
+    void Release();
+
+private:
+    void Add(const glm::vec3& position, const glm::quat& rotation);
+
+    std::vector<GhostInstance> instances_;
+    size_t euler_count_;
+    unsigned long long revision_;
+};
+
+#endif //PROJECT_GHOST_TRAIL_H
@@ -0,0 +1,42 @@
+#ifndef PROJECT_INTERPOLATION_DATA_H
+#define PROJECT_INTERPOLATION_DATA_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <memory>
+
+class SplinePath;
+
+/**
+ * FAST_SLERP is a corrected NLERP: t is remapped by a polynomial in t and
+ * cos(angle) so the rotation speed is nearly constant, with no
+ * trigonometric calls. Its maximum angular error against SLERP is
+ * 8e-4 rad (0.045 degrees), reached for rotations close to 180 degrees.
+ */
+enum class InterpolationMethod {
+    LERP, SLERP, FAST_SLERP
+};
+
+struct InterpolationData {
+    glm::vec3 position_begin;
+    glm::vec3 position_end;
+    // When set, positions follow the path instead of the straight line
+    // from position_begin to position_end.
+    std::shared_ptr<const SplinePath> position_path;
+
+    glm::vec3 euler_begin;
+    glm::vec3 euler_end;
+
+    glm::quat quaternion_begin;
+    glm::quat quaternion_end;
+    InterpolationMethod interpolation_method;
+};
+
+struct InterpolationSimulationCreateParam{
+    float simulation_length_s;
+
+    InterpolationData interpolation_data;
+};
+
+#endif //PROJECT_INTERPOLATION_DATA_H
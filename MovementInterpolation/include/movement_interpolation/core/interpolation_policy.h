@@ -0,0 +1,119 @@
+#ifndef PROJECT_INTERPOLATION_POLICY_H
+#define PROJECT_INTERPOLATION_POLICY_H
+
+#include "movement_interpolation/core/interpolator.h"
+#include "movement_interpolation/core/spline_path.h"
+
+#include <cmath>
+
+/**
+ * Compile time specializations of Interpolator for loops over many
+ * samples. A rotation policy is one InterpolationMethod, a position
+ * policy the straight line or the position path. InterpolationKernel
+ * combines them with every formula inlined, DispatchInterpolation picks
+ * the instantiation once before the loop.
+ */
+
+struct LerpPolicy {
+    static glm::quat Quaternion(const QuaternionConstants& c, float t){
+        return glm::normalize(c.begin * (1.0f - t) + c.end * t);
+    }
+};
+
+struct SlerpPolicy {
+    static glm::quat Quaternion(const QuaternionConstants& c, float t){
+        if(c.linear){
+            return glm::normalize(c.begin * (1.0f - t)
+                                  + c.shortest_end * t);
+        }
+        float w0 = std::sin((1.0f - t) * c.theta) * c.inv_sin_theta;
+        float w1 = std::sin(t * c.theta) * c.inv_sin_theta;
+        return glm::normalize(c.begin * w0 + c.shortest_end * w1);
+    }
+};
+
+struct FastSlerpPolicy {
+    static glm::quat Quaternion(const QuaternionConstants& c, float t){
+        float fast_t = FastSlerpT(t, c.fast_slerp_a, c.fast_slerp_b);
+        return glm::normalize(c.begin * (1.0f - fast_t)
+                              + c.shortest_end * fast_t);
+    }
+};
+
+struct LinearPositionPolicy {
+    static glm::vec3 Position(const InterpolationData& data, float t){
+        return data.position_begin
+               + (data.position_end - data.position_begin) * t;
+    }
+    static glm::vec3 EulerAngles(const InterpolationData& data, float t){
+        return data.euler_begin + (data.euler_end - data.euler_begin) * t;
+    }
+};
+
+struct PathPositionPolicy {
+    static glm::vec3 Position(const InterpolationData& data, float t){
+        return data.position_path->Evaluate(t);
+    }
+};
+
+/**
+ * Interpolator with the method fixed at compile time. Borrows the
+ * interpolator's data, which must outlive the kernel.
+ */
+template<class RotationPolicy, class PositionPolicy>
+class InterpolationKernel {
+public:
+    explicit InterpolationKernel(const Interpolator& interpolator) :
+            data_(interpolator.data()),
+            constants_(interpolator.quaternion_constants()){}
+
+    glm::vec3 Position(float t) const {
+        return PositionPolicy::Position(data_, t);
+    }
+    glm::vec3 EulerAngles(float t) const {
+        return LinearPositionPolicy::EulerAngles(data_, t);
+    }
+    glm::quat Quaternion(float t) const {
+        return RotationPolicy::Quaternion(constants_, t);
+    }
+
+private:
+    const InterpolationData& data_;
+    const QuaternionConstants& constants_;
+};
+
+template<class PositionPolicy, class Visitor>
+void DispatchRotation(const Interpolator& interpolator,
+                      const Visitor& visitor){
+    switch(interpolator.data().interpolation_method){
+        case InterpolationMethod::LERP:
+            visitor(InterpolationKernel<LerpPolicy, PositionPolicy>(
+                    interpolator));
+            break;
+        case InterpolationMethod::SLERP:
+            visitor(InterpolationKernel<SlerpPolicy, PositionPolicy>(
+                    interpolator));
+            break;
+        case InterpolationMethod::FAST_SLERP:
+            visitor(InterpolationKernel<FastSlerpPolicy, PositionPolicy>(
+                    interpolator));
+            break;
+    }
+}
+
+/**
+ * Calls visitor(kernel) once with the InterpolationKernel matching the
+ * interpolator's method and position path. The visitor is a functor with
+ * a templated operator(), the C++11 stand-in for a generic lambda, and
+ * runs the loop.
+ */
+template<class Visitor>
+void DispatchInterpolation(const Interpolator& interpolator,
+                           const Visitor& visitor){
+    if(interpolator.data().position_path)
+        DispatchRotation<PathPositionPolicy>(interpolator, visitor);
+    else
+        DispatchRotation<LinearPositionPolicy>(interpolator, visitor);
+}
+
+#endif //PROJECT_INTERPOLATION_POLICY_H
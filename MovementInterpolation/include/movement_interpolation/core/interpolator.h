@@ -0,0 +1,95 @@
+#ifndef PROJECT_INTERPOLATOR_H
+#define PROJECT_INTERPOLATOR_H
+
+#include "movement_interpolation/core/interpolation_data.h"
+#include "movement_interpolation/core/pose.h"
+
+/**
+ * Per quaternion pair constants, computed once when the data is set.
+ */
+struct QuaternionConstants {
+    glm::quat begin;
+    glm::quat end;
+    // end flipped to the hemisphere of begin.
+    glm::quat shortest_end;
+    float theta;
+    float inv_sin_theta;
+    // Nearly parallel quaternions, SLERP falls back to linear weights.
+    bool linear;
+
+    // FAST_SLERP t correction coefficients, depend on cos(angle) only.
+    float fast_slerp_a;
+    float fast_slerp_b;
+};
+
+/**
+ * Renderer-free interpolation between the begin and end pose of
+ * InterpolationData. Depends only on glm, t is in [0, 1].
+ *
+ * The SLERP constants of the quaternion pair (angle, 1/sin and the
+ * shortest path end) are computed once when the data is set.
+ * Loops over many samples should use InterpolationKernel, which has no
+ * per sample dispatch on the method.
+ */
+class Interpolator {
+public:
+    Interpolator();
+    Interpolator(const InterpolationData& data);
+    ~Interpolator();
+
+    const InterpolationData& data() const {return data_;}
+    void data(const InterpolationData& data);
+    const QuaternionConstants& quaternion_constants() const {
+        return quaternion_constants_;}
+
+    glm::vec3 InterpolatePosition(float t) const;
+    glm::vec3 InterpolateEulerAngles(float t) const;
+
+    glm::quat InterpolateQuaternion(float t) const;
+    /**
+     * Position and interpolated quaternion, ready for PoseToModelMatrix.
+     */
+    Pose InterpolatePose(float t) const;
+    /**
+     * Interpolated quaternion converted to Euler angles in degrees.
+     */
+    glm::vec3 InterpolateQuaternions(float t) const;
+
+    /**
+     * Constant rotation advancing the SLERP path by 1 / steps:
+     * slerp(t + 1 / steps) = slerp(t) * SlerpDelta(steps).
+     */
+    glm::quat SlerpDelta(int steps) const;
+
+private:
+    void UpdateSlerpConstants();
+
+    InterpolationData data_;
+    QuaternionConstants quaternion_constants_;
+};
+
+/**
+ * QuaternionConstants of the rotation from begin to end.
+ */
+QuaternionConstants ComputeQuaternionConstants(const glm::quat& begin,
+                                               const glm::quat& end);
+
+/**
+ * Coefficients and remapping of t used by FAST_SLERP,
+ * cos_theta is the dot product of the shortest path quaternions.
+ */
+void FastSlerpCoefficients(float cos_theta, float& a, float& b);
+inline float FastSlerpT(float t, float a, float b){
+    float k = a * (t - 0.5f) * (t - 0.5f) + b;
+    return t + t * (t - 0.5f) * (t - 1.0f) * k;
+}
+
+glm::vec3 QuaternionToEulerDegrees(const glm::quat& q);
+
+/**
+ * Angle of the rotation between two unit quaternions, in degrees.
+ * q and -q are the same rotation.
+ */
+float AngleDegrees(const glm::quat& a, const glm::quat& b);
+
+#endif //PROJECT_INTERPOLATOR_H
@@ -0,0 +1,96 @@
+#ifndef PROJECT_KEYFRAME_FILE_H
+#define PROJECT_KEYFRAME_FILE_H
+
+#include "movement_interpolation/core/keyframe_track.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Track of a keyframe file, parent is the index of the parent track or
+ * -1, e.g. the joint hierarchy of a BVH file.
+ */
+struct NamedKeyframeTrack {
+    std::string name;
+    int parent;
+    std::shared_ptr<KeyframeTrack> track;
+};
+
+/**
+ * Flat binary keyframe library, memory mapped and used in place.
+ *
+ * Layout, all fields little-endian:
+ *   header (16 bytes):
+ *     char[4] magic "MIKF"
+ *     uint16  version (kKeyframeFileVersion)
+ *     uint16  bytes per key (32)
+ *     uint32  track count
+ *     uint32  reserved, zero
+ *   track table, 56 bytes per track:
+ *     char[32] name, NUL padded
+ *     uint64   offset of the first key from the start of the file
+ *     uint32   key count
+ *     uint32   KeyframeInterpolationMethod
+ *     int32    parent track, -1 for none
+ *     uint32   reserved, zero
+ *   keys, per track sorted by time, 16 byte aligned:
+ *     float32 time, position xyz, rotation xyzw
+ *
+ * Keys have the memory layout of Keyframe, so tracks view them straight
+ * from the mapping. Open checks the header, that every track lies in the
+ * file, its parent and its first and last key, which touches only those
+ * pages. Track checks the order of all keys of a track the first time it
+ * is asked for. Nothing is copied.
+ */
+class KeyframeFile {
+public:
+    static const uint16_t kKeyframeFileVersion = 1;
+
+    KeyframeFile();
+    ~KeyframeFile();
+
+    bool Open(const std::string& path);
+    /**
+     * Tracks handed out by Track keep the mapping alive.
+     */
+    void Close();
+
+    bool IsOpen() const {return (bool)mapping_;}
+    const std::string& error() const {return error_;}
+
+    size_t track_count() const;
+    std::string track_name(size_t index) const;
+    int track_parent(size_t index) const;
+    size_t FindTrack(const std::string& name) const;
+
+    /**
+     * Track viewing the mapped keys of track index, nullptr with error
+     * set if out of range or the key times are not sorted.
+     */
+    std::shared_ptr<KeyframeTrack> Track(size_t index) const;
+
+    static bool Write(const std::string& path,
+                      const std::vector<NamedKeyframeTrack>& tracks);
+
+private:
+    struct Mapping;
+    struct TrackEntry;
+    enum class TrackState : uint8_t {
+        UNCHECKED,
+        SORTED,
+        UNSORTED
+    };
+
+    const TrackEntry* Entry(size_t index) const;
+    bool Validate();
+    bool KeysSorted(const TrackEntry& entry) const;
+
+    std::shared_ptr<Mapping> mapping_;
+    // Also set by Track.
+    mutable std::string error_;
+};
+
+#endif //PROJECT_KEYFRAME_FILE_H
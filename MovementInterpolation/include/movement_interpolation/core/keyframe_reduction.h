@@ -0,0 +1,49 @@
+#ifndef PROJECT_KEYFRAME_REDUCTION_H
+#define PROJECT_KEYFRAME_REDUCTION_H
+
+#include "movement_interpolation/core/keyframe_file.h"
+
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * Largest distance and angle a removed key may be off by.
+ */
+struct ReductionTolerance {
+    float position = 0.001f;
+    float angle_degrees = 0.1f;
+};
+
+struct ReductionStats {
+    size_t source_keys;
+    size_t reduced_keys;
+    // Largest error at the removed keys.
+    float position_error;
+    float angle_error_degrees;
+};
+
+/**
+ * Removes keys of a densely sampled track as long as the piecewise
+ * reconstruction, linear positions and LERP or SLERP rotations like
+ * KeyframeTrack::Evaluate, stays within tolerance at every source key.
+ *
+ * Splits at the worst key until every segment is within tolerance
+ * (Ramer-Douglas-Peucker), O(n log n) for typical motion. SQUAD tracks
+ * are reduced and returned as SLERP tracks.
+ */
+ReductionStats ReduceKeyframes(const KeyframeTrack& track,
+                               const ReductionTolerance& tolerance,
+                               KeyframeTrack& reduced);
+
+/**
+ * Reduces every track, in parallel on thread_pool if given. Names and
+ * parents are kept.
+ */
+ReductionStats ReduceKeyframes(const std::vector<NamedKeyframeTrack>& tracks,
+                               const ReductionTolerance& tolerance,
+                               std::vector<NamedKeyframeTrack>& reduced,
+                               ThreadPool* thread_pool = nullptr);
+
+#endif //PROJECT_KEYFRAME_REDUCTION_H
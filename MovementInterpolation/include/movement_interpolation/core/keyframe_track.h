@@ -0,0 +1,91 @@
+#ifndef PROJECT_KEYFRAME_TRACK_H
+#define PROJECT_KEYFRAME_TRACK_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <cstddef>
+
+enum class KeyframeInterpolationMethod {
+    LERP, SLERP, SQUAD
+};
+
+struct Keyframe {
+    float time;
+    glm::vec3 position;
+    glm::quat rotation;
+};
+
+/**
+ * Time stamped positions and rotations evaluated piecewise.
+ * Positions are always interpolated linearly, rotations with the
+ * selected method.
+ *
+ * The segment lookup remembers the last segment, so monotonic playback
+ * is O(1) amortized and random seeks fall back to a binary search.
+ * Because of that cursor a single track must not be evaluated from
+ * several threads at once.
+ *
+ * Keys are either owned by the track or viewed in place, see View.
+ */
+class KeyframeTrack {
+public:
+    KeyframeTrack();
+    ~KeyframeTrack();
+
+    KeyframeInterpolationMethod interpolation_method() const {
+        return interpolation_method_;}
+    void interpolation_method(KeyframeInterpolationMethod method){
+        interpolation_method_ = method;}
+
+    const Keyframe* keys() const {return keys_;}
+    size_t size() const {return size_;}
+    bool is_view() const {return is_view_;}
+
+    float start_time() const;
+    float end_time() const;
+    float duration() const {return end_time() - start_time();}
+
+    /**
+     * Keeps the keys sorted by time, appending in order is O(1).
+     */
+    void AddKey(const Keyframe& key);
+    void Reserve(size_t count);
+    void Clear();
+
+    /**
+     * Uses count keys, sorted by time, in place without copying them,
+     * e.g. keys of a memory mapped KeyframeFile. They must outlive the
+     * view. AddKey copies them into owned storage first.
+     */
+    void View(const Keyframe* keys, size_t count);
+
+    void Evaluate(float time, glm::vec3& position, glm::quat& rotation) const;
+    glm::vec3 EvaluatePosition(float time) const;
+    glm::quat EvaluateRotation(float time) const;
+
+private:
+    /**
+     * Index i of the segment [keys_[i], keys_[i+1]] containing time.
+     */
+    size_t FindSegment(float time) const;
+    float SegmentT(size_t segment, float time) const;
+    glm::quat InterpolateRotation(size_t segment, float t) const;
+
+    void UpdateSquadControlPoints() const;
+    void UseOwnedKeys();
+
+    std::vector<Keyframe> owned_keys_;
+    const Keyframe* keys_;
+    size_t size_;
+    bool is_view_;
+    KeyframeInterpolationMethod interpolation_method_;
+
+    mutable size_t cursor_;
+
+    mutable std::vector<glm::quat> squad_control_points_;
+    mutable bool squad_control_points_dirty_;
+};
+
+#endif //PROJECT_KEYFRAME_TRACK_H
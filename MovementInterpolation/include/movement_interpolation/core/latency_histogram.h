@@ -0,0 +1,53 @@
+#ifndef PROJECT_LATENCY_HISTOGRAM_H
+#define PROJECT_LATENCY_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * In seconds, 0 until something was added.
+ */
+struct LatencyPercentiles {
+    float p50;
+    float p95;
+    float p99;
+};
+
+/**
+ * Rolling percentiles of the last kWindowSize durations.
+ * Durations are counted in logarithmic buckets, kBucketsPerOctave per
+ * doubling from 1 us up to about 1 s, so a percentile is accurate to
+ * about 9% and Add is O(1). All storage is inline, nothing is allocated
+ * and copies are plain memory copies.
+ */
+class LatencyHistogram {
+public:
+    static const int kBucketsPerOctave = 8;
+    static const int kBucketCount = 20 * kBucketsPerOctave;
+    static const size_t kWindowSize = 512;
+
+    LatencyHistogram();
+
+    size_t count() const {return count_;}
+
+    void Add(double seconds);
+    void Clear();
+
+    /**
+     * Upper bound of the bucket holding the given fraction of the window.
+     */
+    float Percentile(float fraction) const;
+    LatencyPercentiles Percentiles() const;
+
+private:
+    static uint8_t Bucket(double seconds);
+    static float BucketUpperBound(int bucket);
+
+    uint16_t bucket_counts_[kBucketCount];
+    // Bucket of every duration in the window, oldest at next_ once full.
+    uint8_t window_[kWindowSize];
+    size_t next_;
+    size_t count_;
+};
+
+#endif //PROJECT_LATENCY_HISTOGRAM_H
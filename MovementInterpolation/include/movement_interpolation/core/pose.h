@@ -0,0 +1,18 @@
+#ifndef PROJECT_POSE_H
+#define PROJECT_POSE_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+struct Pose {
+    glm::vec3 position;
+    glm::quat rotation;
+};
+
+/**
+ * Translation * Rotation * Scale built straight from the quaternion,
+ * no Euler angles or trigonometry involved.
+ */
+glm::mat4 PoseToModelMatrix(const Pose& pose, float scale = 1.0f);
+
+#endif //PROJECT_POSE_H
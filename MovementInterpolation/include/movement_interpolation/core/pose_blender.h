@@ -0,0 +1,58 @@
+#ifndef PROJECT_POSE_BLENDER_H
+#define PROJECT_POSE_BLENDER_H
+
+#include "movement_interpolation/core/pose.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Weighted blend of N input poses for each of M objects, e.g. the
+ * tracks of a locomotion blend space.
+ *
+ * Inputs are written in place through input(), one contiguous block of
+ * object_count poses per input. Blend sums the weighted positions and
+ * accumulates the rotations in the hemisphere of the first weighted
+ * input before normalizing, so q and -q pull the same way.
+ *
+ * Storage is sized by Resize only, blending never allocates.
+ */
+class PoseBlender {
+public:
+    PoseBlender();
+    ~PoseBlender();
+
+    size_t input_count() const {return weights_.size();}
+    size_t object_count() const {return object_count_;}
+
+    /**
+     * Keeps the weights of inputs that still exist, new inputs start
+     * with weight 0.
+     */
+    void Resize(size_t input_count, size_t object_count);
+
+    Pose* input(size_t index){
+        return inputs_.data() + index * object_count_;}
+    const Pose* input(size_t index) const {
+        return inputs_.data() + index * object_count_;}
+
+    /**
+     * Relative weights, normalized by their sum in Blend.
+     * Negative weights count as 0.
+     */
+    float weight(size_t index) const {return weights_[index];}
+    void weight(size_t index, float value){weights_[index] = value;}
+
+    /**
+     * Writes object_count poses to output. Without any positive weight
+     * the first input is copied.
+     */
+    void Blend(Pose* output) const;
+
+private:
+    size_t object_count_;
+    std::vector<Pose> inputs_;
+    std::vector<float> weights_;
+};
+
+#endif //PROJECT_POSE_BLENDER_H
@@ -0,0 +1,30 @@
+#ifndef PROJECT_ROTATION_STEPPER_H
+#define PROJECT_ROTATION_STEPPER_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+/**
+ * Walks a constant angular velocity rotation with one quaternion multiply
+ * per step instead of a SLERP. Rounding drift is removed by renormalizing
+ * every renormalize_interval steps.
+ */
+class RotationStepper {
+public:
+    RotationStepper(const glm::quat& start, const glm::quat& delta,
+                    int renormalize_interval = 16);
+    ~RotationStepper();
+
+    const glm::quat& current() const {return current_;}
+
+    void Step();
+
+private:
+    glm::quat current_;
+    glm::quat delta_;
+
+    int renormalize_interval_;
+    int steps_since_renormalize_;
+};
+
+#endif //PROJECT_ROTATION_STEPPER_H
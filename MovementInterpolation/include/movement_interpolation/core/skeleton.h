@@ -0,0 +1,90 @@
+#ifndef PROJECT_SKELETON_H
+#define PROJECT_SKELETON_H
+
+#include "movement_interpolation/core/keyframe_track.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Joint hierarchy as a parent index array. Parents always come before
+ * their children, so one forward pass visits every parent first.
+ */
+class Skeleton {
+public:
+    Skeleton();
+    ~Skeleton();
+
+    size_t size() const {return parents_.size();}
+    const std::vector<int>& parents() const {return parents_;}
+    const std::string& name(size_t joint) const {return names_[joint];}
+
+    /**
+     * parent is an existing joint or -1 for a root. Returns the index of
+     * the new joint, -1 if parent does not exist yet.
+     */
+    int AddJoint(const std::string& name, int parent);
+    void Clear();
+
+private:
+    std::vector<int> parents_;
+    std::vector<std::string> names_;
+};
+
+/**
+ * Transforms of all joints of a skeleton, structure of arrays.
+ * Local poses are relative to the parent joint, world poses to the
+ * skeleton origin.
+ */
+struct SkeletonPose {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+
+    void Resize(size_t count);
+    size_t size() const {return positions.size();}
+};
+
+/**
+ * Composes local poses into world poses in one linear sweep.
+ * Joints beyond the size of local are left out.
+ */
+void LocalToWorld(const Skeleton& skeleton, const SkeletonPose& local,
+                  SkeletonPose& world);
+
+/**
+ * Keyframed skeleton animation, one track of local poses per joint.
+ * Every track is sampled at the same time with its own interpolation
+ * method, then the world pose is composed by LocalToWorld.
+ */
+class SkeletonTrack {
+public:
+    SkeletonTrack();
+    ~SkeletonTrack();
+
+    /**
+     * False, leaving the track empty, unless there is a track per joint.
+     */
+    bool Set(std::shared_ptr<const Skeleton> skeleton,
+             const std::vector<std::shared_ptr<KeyframeTrack>>& tracks);
+
+    std::shared_ptr<const Skeleton> skeleton() const {return skeleton_;}
+    float start_time() const {return start_time_;}
+    float duration() const {return end_time_ - start_time_;}
+
+    /**
+     * time is relative to start_time. Joints without keys keep the
+     * identity transform.
+     */
+    void EvaluateLocal(float time, SkeletonPose& local) const;
+    void Evaluate(float time, SkeletonPose& local, SkeletonPose& world) const;
+
+private:
+    std::shared_ptr<const Skeleton> skeleton_;
+    std::vector<std::shared_ptr<KeyframeTrack>> tracks_;
+    float start_time_;
+    float end_time_;
+};
+
+#endif //PROJECT_SKELETON_H
@@ -0,0 +1,67 @@
+#ifndef PROJECT_SPLINE_PATH_H
+#define PROJECT_SPLINE_PATH_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstddef>
+
+enum class SplineType {
+    // Passes through every control point.
+    CATMULL_ROM,
+    // Piecewise cubic, points 3k are on the path, the others are handles.
+    // Needs 3k + 1 points, extra points are ignored.
+    BEZIER
+};
+
+/**
+ * Curved position path evaluated at t in [0, 1].
+ *
+ * With constant_speed t is the travelled fraction of the path length
+ * instead of the spline parameter. The arc length lookup table behind it
+ * is rebuilt when the control points or the type change, evaluation is
+ * O(1) and allocation free, so a path can be shared by many objects and
+ * threads once built.
+ */
+class SplinePath {
+public:
+    SplinePath(SplineType type = SplineType::CATMULL_ROM);
+    SplinePath(SplineType type, const std::vector<glm::vec3>& control_points);
+    ~SplinePath();
+
+    SplineType type() const {return type_;}
+    void type(SplineType type);
+
+    const std::vector<glm::vec3>& control_points() const {
+        return control_points_;}
+    void control_points(const std::vector<glm::vec3>& control_points);
+
+    bool constant_speed() const {return constant_speed_;}
+    void constant_speed(bool value){constant_speed_ = value;}
+
+    size_t segment_count() const;
+    float length() const {return length_;}
+
+    glm::vec3 Evaluate(float t) const;
+    /**
+     * Position at spline parameter u in [0, 1], segments uniformly spaced.
+     */
+    glm::vec3 EvaluateParameter(float u) const;
+    /**
+     * Spline parameter at fraction t of the path length.
+     */
+    float ParameterAt(float t) const;
+
+private:
+    void BuildLookupTable();
+
+    SplineType type_;
+    std::vector<glm::vec3> control_points_;
+    bool constant_speed_;
+
+    float length_;
+    // Spline parameter at arc length i / (size - 1) * length_.
+    std::vector<float> parameters_;
+};
+
+#endif //PROJECT_SPLINE_PATH_H
@@ -0,0 +1,63 @@
+#ifndef PROJECT_SPSC_QUEUE_H
+#define PROJECT_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Bounded lock free queue for exactly one producer and one consumer
+ * thread. Storage is allocated once, pushing and popping only move
+ * values in and out of it.
+ */
+template<class T>
+class SpscQueue {
+public:
+    SpscQueue(size_t capacity) :
+            slots_(capacity + 1), head_(0), tail_(0){}
+
+    size_t capacity() const {return slots_.size() - 1;}
+
+    /**
+     * Producer side. value is only moved from when true is returned,
+     * false means the queue is full.
+     */
+    bool TryPush(T&& value){
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t next = Next(tail);
+        if(next == head_.load(std::memory_order_acquire))
+            return false;
+        slots_[tail] = std::move(value);
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+    bool TryPush(const T& value){
+        T copy(value);
+        return TryPush(std::move(copy));
+    }
+
+    /**
+     * Consumer side, false when the queue is empty.
+     */
+    bool TryPop(T& value){
+        size_t head = head_.load(std::memory_order_relaxed);
+        if(head == tail_.load(std::memory_order_acquire))
+            return false;
+        value = std::move(slots_[head]);
+        head_.store(Next(head), std::memory_order_release);
+        return true;
+    }
+
+private:
+    size_t Next(size_t index) const {
+        return index + 1 == slots_.size() ? 0 : index + 1;
+    }
+
+    std::vector<T> slots_;
+
+    std::atomic<size_t> head_;
+    std::atomic<size_t> tail_;
+};
+
+#endif //PROJECT_SPSC_QUEUE_H
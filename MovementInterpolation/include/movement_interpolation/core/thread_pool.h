@@ -0,0 +1,69 @@
+#ifndef PROJECT_THREAD_POOL_H
+#define PROJECT_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads with one task queue each. Tasks submitted
+ * by a worker go to its own queue and are run newest first, tasks from
+ * other threads are spread round robin. An idle worker steals the oldest
+ * task of another queue, so uneven tasks keep every worker busy and the
+ * workers do not contend on a single queue lock.
+ */
+class ThreadPool {
+public:
+    /**
+     * thread_count 0 uses one thread per hardware thread.
+     */
+    ThreadPool(unsigned int thread_count = 0);
+    ~ThreadPool();
+
+    unsigned int size() const {return (unsigned int)workers_.size();}
+
+    void Submit(std::function<void()> task);
+
+    /**
+     * Runs body(begin, end) over [0, count) in chunks of grain and blocks
+     * until all chunks finished. Must not be called from a pool task.
+     */
+    void ParallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t)>& body);
+
+    /**
+     * Blocks until all queues are empty and no task is running.
+     */
+    void Wait();
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(size_t index);
+    bool TryPop(size_t index, std::function<void()>& task);
+    bool TrySteal(size_t index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_queue_;
+
+    // Sleeping workers and Wait, pending_ counts queued tasks.
+    std::mutex mutex_;
+    std::condition_variable task_condition_;
+    std::condition_variable idle_condition_;
+
+    std::atomic<size_t> pending_;
+    std::atomic<unsigned int> active_;
+    bool stop_;
+};
+
+#endif //PROJECT_THREAD_POOL_H
@@ -0,0 +1,65 @@
+#ifndef PROJECT_TRACE_H
+#define PROJECT_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Scoped timers recorded into per thread ring buffers and dumped as
+ * Chrome trace events (chrome://tracing, Perfetto).
+ *
+ * TRACE_SCOPE and TRACE_THREAD_NAME compile to nothing unless the
+ * MOVEMENT_INTERPOLATION_TRACE CMake option is on. Names must be string
+ * literals, only the pointer is stored.
+ */
+#ifdef MOVEMENT_INTERPOLATION_TRACE
+const bool kTraceEnabled = true;
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) \
+        ScopedTrace TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) TraceRecorder::SetThreadName(name)
+#else
+const bool kTraceEnabled = false;
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+/**
+ * Every thread writes to its own ring buffer without locks, the oldest
+ * events are overwritten once it is full. Write may run on any thread
+ * while others record, events overwritten during the copy are dropped.
+ */
+class TraceRecorder {
+public:
+    static const size_t kEventsPerThread = 1 << 15;
+
+    /**
+     * Nanoseconds since the first call, steady clock.
+     */
+    static uint64_t Now();
+    static void Record(const char* name, uint64_t begin, uint64_t end);
+    static void SetThreadName(const char* name);
+
+    static bool WriteChromeTrace(const std::string& path);
+};
+
+class ScopedTrace {
+public:
+    ScopedTrace(const char* name) :
+            name_(name), begin_(TraceRecorder::Now()){}
+    ~ScopedTrace(){
+        TraceRecorder::Record(name_, begin_, TraceRecorder::Now());}
+
+private:
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    const char* name_;
+    uint64_t begin_;
+};
+
+#endif //PROJECT_TRACE_H
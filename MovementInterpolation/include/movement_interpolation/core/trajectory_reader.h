@@ -0,0 +1,18 @@
+#ifndef PROJECT_TRAJECTORY_READER_H
+#define PROJECT_TRAJECTORY_READER_H
+
+#include "movement_interpolation/core/trajectory_writer.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Reads a binary trajectory written by TrajectoryWriter, see there for
+ * the layout. A sample count of 0 reads samples until the end of the
+ * file. On failure returns false and describes the problem in error.
+ */
+bool ReadTrajectory(const std::string& path,
+                    std::vector<TrajectorySample>& samples,
+                    float& simulation_length, std::string& error);
+
+#endif //PROJECT_TRAJECTORY_READER_H
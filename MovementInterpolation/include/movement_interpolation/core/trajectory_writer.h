@@ -0,0 +1,93 @@
+#ifndef PROJECT_TRAJECTORY_WRITER_H
+#define PROJECT_TRAJECTORY_WRITER_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class Interpolator;
+
+enum class TrajectoryFormat {
+    BINARY,
+    // Human readable, for debugging.
+    CSV
+};
+
+/**
+ * One sampled frame. Both paths share the position, the Euler path
+ * rotates by euler_angles (degrees) and the quaternion path by quaternion.
+ */
+struct TrajectorySample {
+    float time;
+    glm::vec3 position;
+    glm::vec3 euler_angles;
+    glm::quat quaternion;
+};
+
+/**
+ * Streams samples to a file through a fixed size buffer, memory use does
+ * not depend on the number of samples.
+ *
+ * Binary layout, all fields little-endian:
+ *   header (32 bytes):
+ *     char[4]  magic "MITR"
+ *     uint16   version (kTrajectoryVersion)
+ *     uint16   floats per sample (11)
+ *     uint64   sample count, patched by Close. 0 when the file could not
+ *              be seeked, read samples until the end of the file then.
+ *     float32  simulation length in seconds
+ *     uint8[12] reserved, zero
+ *   samples: float32 time, position xyz, euler xyz, quaternion wxyz
+ */
+class TrajectoryWriter {
+public:
+    static const uint16_t kTrajectoryVersion = 1;
+    static const size_t kHeaderSize = 32;
+    static const size_t kFloatsPerSample = 11;
+
+    TrajectoryWriter(size_t buffer_size = 64 * 1024);
+    ~TrajectoryWriter();
+
+    bool Open(const std::string& path, TrajectoryFormat format,
+              float simulation_length);
+    bool Write(const TrajectorySample& sample);
+    /**
+     * Flushes the buffer and finalizes the header, false if any write
+     * since Open failed.
+     */
+    bool Close();
+
+    bool IsOpen() const {return file_ != nullptr;}
+    uint64_t samples_written() const {return samples_written_;}
+
+private:
+    bool Flush();
+    void Reserve(size_t bytes);
+
+    void PutUint16(uint16_t value);
+    void PutUint32(uint32_t value);
+    void PutUint64(uint64_t value);
+    void PutFloat(float value);
+
+    FILE* file_;
+    TrajectoryFormat format_;
+    std::vector<unsigned char> buffer_;
+    size_t used_;
+
+    uint64_t samples_written_;
+    bool failed_;
+};
+
+/**
+ * Writes count frames at t = i / count, the frames SimulateFrames samples,
+ * computing them as they are written.
+ */
+bool ExportTrajectory(const Interpolator& interpolator, int count,
+                      float simulation_length, TrajectoryWriter& writer);
+
+#endif //PROJECT_TRAJECTORY_WRITER_H
@@ -0,0 +1,53 @@
+#ifndef PROJECT_TRIPLE_BUFFER_H
+#define PROJECT_TRIPLE_BUFFER_H
+
+#include <atomic>
+
+/**
+ * Lock free handoff of the latest value from one writer thread to one
+ * reader thread. The writer fills write_buffer() and publishes it, the
+ * reader picks up the newest published value with Update. Neither side
+ * ever waits, values published in between are skipped.
+ */
+template<class T>
+class TripleBuffer {
+public:
+    TripleBuffer() :
+            write_(0), middle_(1), read_(2){}
+
+    /**
+     * Writer side.
+     */
+    T& write_buffer(){return buffers_[write_];}
+    void Publish(){
+        write_ = middle_.exchange(write_ | kFresh,
+                                  std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    /**
+     * Reader side. Returns true when a newer value was published since
+     * the last call.
+     */
+    bool Update(){
+        if(!(middle_.load(std::memory_order_relaxed) & kFresh))
+            return false;
+        read_ = middle_.exchange(read_, std::memory_order_acq_rel)
+                & kIndexMask;
+        return true;
+    }
+    const T& read_buffer() const {return buffers_[read_];}
+
+private:
+    static const unsigned int kIndexMask = 3;
+    static const unsigned int kFresh = 4;
+
+    T buffers_[3];
+
+    unsigned int write_;
+    // Index of the buffer between writer and reader, kFresh when it holds
+    // a value the reader has not seen.
+    std::atomic<unsigned int> middle_;
+    unsigned int read_;
+};
+
+#endif //PROJECT_TRIPLE_BUFFER_H
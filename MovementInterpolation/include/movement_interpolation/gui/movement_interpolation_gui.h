@@ -3,6 +3,10 @@
 
 #include <gui/gui.h>
 
+#include <glm/gtc/quaternion.hpp>
+#include "movement_interpolation/core/spline_path.h"
+#include "movement_interpolation/core/latency_histogram.h"
+
 #include <memory>
 
 namespace ifx{
@@ -27,17 +31,28 @@ private:
     void RenderGUI();
 
     void RenderSimulationInfo();
+    void RenderFrameSamplingMode();
+    void RenderExport(int frames_count);
+    void RenderBlendWeights();
+    void RenderPerformance();
 
     void RenderInterpolationInfo();
-    void RenderBeginPosition();
-    void RenderEndPosition();
-
-    void RenderBeginEulerAngles();
-    void RenderEndEulerAngles();
+    /**
+     * The Render* widget helpers edit simulation_create_param_ in place
+     * and return true only when the user changed a value.
+     */
+    bool RenderBeginPosition();
+    bool RenderEndPosition();
+    bool RenderSplinePath();
+    void UpdateSplinePath();
+
+    bool RenderBeginEulerAngles();
+    bool RenderEndEulerAngles();
 
     void RenderQuaternionInterpolationType();
-    void RenderBeginQuaternionAngles();
-    void RenderEndQuaternionAngles();
+    bool RenderBeginQuaternionAngles();
+    bool RenderEndQuaternionAngles();
+    bool RenderQuaternion(const char* label, glm::quat& quaternion);
 
     void InitSimulationCreateParams();
 
@@ -49,6 +64,26 @@ private:
 
     std::shared_ptr<InterpolationSimulationCreateParam>
             simulation_create_param_;
+
+    // Forces one UpdatePosition after construction.
+    bool scene_dirty_;
+
+    char export_path_[256];
+    bool export_csv_;
+
+    bool spline_enabled_;
+    SplineType spline_type_;
+    bool spline_constant_speed_;
+    // Between the begin and end position, which close the path.
+    glm::vec3 spline_control_points_[2];
+
+    bool trace_dumped_;
+    bool trace_written_;
+
+    // Time to build and render the GUI, measured on the render thread.
+    LatencyHistogram gui_latency_;
+    unsigned long long allocation_count_;
+    unsigned long long frame_allocations_;
 };
 
 
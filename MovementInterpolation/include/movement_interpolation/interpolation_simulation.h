@@ -3,8 +3,27 @@
 
 #include <vr/simulation.h>
 #include <math/math_ifx.h>
+#include "movement_interpolation/core/interpolation_data.h"
+#include "movement_interpolation/core/interpolator.h"
+#include "movement_interpolation/core/pose.h"
+#include "movement_interpolation/core/keyframe_track.h"
+#include "movement_interpolation/core/skeleton.h"
+#include "movement_interpolation/core/pose_blender.h"
+#include "movement_interpolation/core/clock.h"
+#include "movement_interpolation/core/fixed_step_scheduler.h"
+#include "movement_interpolation/core/frame_sampler.h"
+#include "movement_interpolation/core/ghost_trail.h"
+#include "movement_interpolation/core/spsc_queue.h"
+#include "movement_interpolation/core/triple_buffer.h"
+#include "movement_interpolation/core/trajectory_writer.h"
+#include "movement_interpolation/simulation_command.h"
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 /**
@@ -15,29 +34,12 @@ namespace ifx{
 class Scene;
 class RenderObject;
 class Renderer;
+class Model;
 }
 
-enum class InterpolationMethod {
-    LERP, SLERP
-};
-
-struct InterpolationData {
-    glm::vec3 position_begin;
-    glm::vec3 position_end;
-
-    glm::vec3 euler_begin;
-    glm::vec3 euler_end;
-
-    glm::quat quaternion_begin;
-    glm::quat quaternion_end;
-    InterpolationMethod interpolation_method;
-};
-
-struct InterpolationSimulationCreateParam{
-    float simulation_length_s;
-
-    InterpolationData interpolation_data;
-};
+class PoseRenderObject;
+class GhostTrailRenderObject;
+class ThreadPool;
 
 // In seconds
 struct TimeData{
@@ -50,6 +52,16 @@ struct TimeData{
 
     float time_since_last_update;
     const float time_delta = 1.0f / 60.0f;
+
+    // Fraction of time_delta the rendered pose lags behind total_time.
+    float alpha;
+};
+
+enum class ExportStatus {
+    IDLE,
+    RUNNING,
+    DONE,
+    FAILED
 };
 
 struct RenderObjects{
@@ -57,49 +69,211 @@ struct RenderObjects{
     std::shared_ptr<ifx::RenderObject> render_object_end_;
 
     std::shared_ptr<ifx::RenderObject> render_object_euler_current_;
-    std::shared_ptr<ifx::RenderObject> render_object_quaternion_current_;
+    // Placed straight from the quaternion, see PoseRenderObject.
+    std::shared_ptr<PoseRenderObject> render_object_quaternion_current_;
+
+    // World poses of the skeleton joints, rebuilt in place every frame.
+    std::shared_ptr<GhostTrailRenderObject> skeleton_joints_;
 
-    std::vector<std::shared_ptr<ifx::RenderObject>> render_objects_euler;
-    std::vector<std::shared_ptr<ifx::RenderObject>> render_objects_quaternion;
+    // Frames of both paths produced by SimulateFrames, one group that is
+    // drawn as a whole and rebuilt in place instead of scene objects.
+    std::shared_ptr<GhostTrailRenderObject> ghost_trail_;
 };
 
+/**
+ * Commands (Reset, SetRunning, SimulateFrames, ...) are queued and
+ * executed by the thread that owns the simulation: the render thread in
+ * Update, or the simulation thread when RunOnThread is enabled. Each
+ * step publishes a SimulationState that Update applies to the scene.
+ */
 class InterpolationSimulation : public ifx::Simulation {
 public:
 
     InterpolationSimulation(std::shared_ptr<ifx::Scene> scene,
                             std::shared_ptr<ifx::Renderer> renderer,
-                            std::shared_ptr<ifx::RenderObject> render_object);
+                            std::shared_ptr<ifx::RenderObject> render_object,
+                            std::shared_ptr<ifx::Model> model);
     ~InterpolationSimulation();
 
-    InterpolationData& interpolation_data(){return interpolation_data_;}
+    /**
+     * Owned by the simulation, only safe to read while not on its thread.
+     */
+    const InterpolationData& interpolation_data(){
+        return interpolator_.data();}
     TimeData& time_data(){return time_data_;}
+    FixedStepScheduler& scheduler(){return scheduler_;}
 
-    void SetRunning(bool value) override;
+    /**
+     * Render thread side.
+     */
+    const SimulationState& state(){return state_;}
+    const GhostTrail& ghost_trail();
+
+    /**
+     * Runs the fixed steps on a dedicated thread so slow render or GUI
+     * frames do not delay them.
+     */
+    void RunOnThread(bool value);
+    bool runs_on_thread(){return thread_.joinable();}
+
+    /**
+     * Euler angles of the current quaternion pose are only computed
+     * when enabled, they are not needed for rendering.
+     */
+    bool euler_diagnostics(){return euler_diagnostics_;}
+    void euler_diagnostics(bool value){euler_diagnostics_ = value;}
+    const glm::vec3& quaternion_euler(){return quaternion_euler_;}
+
+    /**
+     * Defaults to WallClock. A ManualClock replays the simulation
+     * deterministically, independent of the frame rate.
+     * Not while running on the simulation thread.
+     */
+    void SetClock(std::shared_ptr<Clock> clock);
+
+    /**
+     * When set, Update plays the keyframe track back instead of
+     * interpolating between the begin and end pose, for the duration of
+     * the track. Not while running on the simulation thread.
+     */
+    void SetKeyframeTrack(std::shared_ptr<KeyframeTrack> keyframe_track);
+    std::shared_ptr<KeyframeTrack> keyframe_track(){return keyframe_track_;}
+
+    /**
+     * When set, every step also samples the skeleton animation at the
+     * same fraction of its duration and draws its joints.
+     * Not while running on the simulation thread.
+     */
+    void SetSkeleton(std::shared_ptr<SkeletonTrack> skeleton);
+    std::shared_ptr<SkeletonTrack> skeleton(){return skeleton_;}
+
+    /**
+     * When set, the current pose is the weighted blend of the tracks,
+     * each sampled at the same fraction of its duration. Takes
+     * precedence over the keyframe track. Starts with equal weights.
+     * Not while running on the simulation thread.
+     */
+    void SetBlendTracks(
+            const std::vector<std::shared_ptr<KeyframeTrack>>& tracks);
+    size_t blend_input_count(){return blend_weights_.size();}
+    float blend_weight(size_t input){return blend_weights_[input];}
+    void SetBlendWeight(size_t input, float weight);
 
     void UpdatePosition(
             std::shared_ptr<InterpolationSimulationCreateParam> params);
+
+    /**
+     * Queues a command, false if the queue is full, in which case nothing
+     * changed. Must be called from the render thread.
+     */
+    bool Post(const SimulationCommand& command);
+
+    /**
+     * Commands the queue was full for, posted again by Update.
+     */
+    size_t pending_command_count(){return pending_commands_.size();}
+
+    void SetRunning(bool value) override;
     void Reset(std::shared_ptr<InterpolationSimulationCreateParam> params);
     virtual void Update() override;
 
+    /**
+     * Samples the frames on the thread pool, they are added to the scene
+     * by Update once sampling finished.
+     */
     void SimulateFrames(int count,
                         std::shared_ptr<InterpolationSimulationCreateParam> param);
+    FrameSamplingMode frame_sampling_mode(){return frame_sampling_mode_;}
+    void frame_sampling_mode(FrameSamplingMode mode){
+        frame_sampling_mode_ = mode;}
+    AdaptiveTolerance& adaptive_tolerance(){return adaptive_tolerance_;}
+    bool IsSimulatingFrames(){return state_.simulating_frames;}
+    float simulate_frames_progress(){
+        return state_.simulate_frames_progress;}
+    void CancelSimulateFrames();
+
+    /**
+     * Streams count frames to path on the thread pool, in constant memory.
+     * False if an export is still running.
+     */
+    bool ExportFrames(int count,
+                      std::shared_ptr<InterpolationSimulationCreateParam> param,
+                      const std::string& path, TrajectoryFormat format);
+    ExportStatus export_status(){return *export_status_;}
+
 private:
-    void Update(double time_elapsed);
+    // Simulation thread side.
+    void SimulationLoop();
+    void Tick();
+    void Execute(const SimulationCommand& command);
+    void ExecuteReset(const InterpolationSimulationCreateParam& param);
+    void ExecuteSimulateFrames(const SimulationCommand& command);
+    void TimedStep(double time_elapsed);
+    void Step(double time_elapsed);
+    // time as a fraction of the simulation length, at most 1.
+    float Fraction(float time);
+    void StepKeyframeTrack(float time);
+    void StepSkeleton(float t);
+    void StepBlend(float t);
+    void PublishSimulatedFrames();
+    void Publish();
 
-    glm::vec3 InterpolatePosition(float t);
-    glm::vec3 InterpolateEulerAngles(float t);
-    glm::vec3 InterpolateQuaternions(float t);
+    // Render thread side.
+    void Send(const SimulationCommand& command);
+    void PostPendingCommands();
+    void ApplyState(const SimulationState& state);
+    void CommitSimulatedFrames();
 
     void InitScene(std::shared_ptr<ifx::Scene> scene,
-                   std::shared_ptr<ifx::RenderObject> render_object);
+                   std::shared_ptr<ifx::RenderObject> render_object,
+                   std::shared_ptr<ifx::Model> model);
     void InitParameters();
 
-    InterpolationData interpolation_data_;
+    Interpolator interpolator_;
+    std::shared_ptr<KeyframeTrack> keyframe_track_;
+    std::shared_ptr<SkeletonTrack> skeleton_;
+    SkeletonPose skeleton_local_;
+    std::vector<std::shared_ptr<KeyframeTrack>> blend_tracks_;
+    PoseBlender pose_blender_;
     TimeData time_data_;
+    std::shared_ptr<Clock> clock_;
+    FixedStepScheduler scheduler_;
+    SimulationState simulation_state_;
+    LatencyHistogram step_latency_;
+    LatencyHistogram simulate_frames_latency_;
+    std::chrono::steady_clock::time_point simulate_frames_begin_;
 
     std::shared_ptr<ifx::Scene> scene_;
     std::shared_ptr<ifx::Renderer> renderer_;
     RenderObjects render_objects;
+    SimulationState state_;
+
+    std::shared_ptr<ThreadPool> thread_pool_;
+    FrameSampler frame_sampler_;
+    FrameSamplingMode frame_sampling_mode_;
+    AdaptiveTolerance adaptive_tolerance_;
+    FrameSamples frame_samples_;
+    unsigned int frames_generation_;
+    unsigned int generation_;
+    // Shared with the export task, which may outlive the simulation.
+    std::shared_ptr<std::atomic<ExportStatus>> export_status_;
+
+    // Render thread -> simulation.
+    SpscQueue<SimulationCommand> commands_;
+    // Sent while commands_ was full, oldest first.
+    std::deque<SimulationCommand> pending_commands_;
+    SpscQueue<FrameSamples> recycled_samples_;
+    // Simulation -> render thread.
+    TripleBuffer<SimulationState> published_state_;
+    SpscQueue<SimulatedFrames> simulated_frames_;
+
+    std::thread thread_;
+    std::atomic<bool> stop_thread_;
+
+    bool euler_diagnostics_;
+    glm::vec3 quaternion_euler_;
+    // Render thread copy of the weights sent with SetBlendWeight.
+    std::vector<float> blend_weights_;
 };
 
 
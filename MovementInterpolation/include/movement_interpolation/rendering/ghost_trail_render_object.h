@@ -0,0 +1,74 @@
+#ifndef PROJECT_GHOST_TRAIL_RENDER_OBJECT_H
+#define PROJECT_GHOST_TRAIL_RENDER_OBJECT_H
+
+#include "movement_interpolation/core/ghost_trail.h"
+
+#include <object/render_object.h>
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace ifx{
+class Scene;
+class Model;
+}
+
+/**
+ * Draws every pose of its GhostTrail as an instance of the model the
+ * object was copied from, one instanced call per mesh of that model.
+ * It is added to the scene like any render object, so the trail is drawn
+ * by the renderer with the rest of the scene, with the instancing program
+ * the object adds to its programs. The model matrix of the object, e.g.
+ * its scale, is applied before the pose of each instance.
+ *
+ * The instance attributes are looked up by name in the program being
+ * drawn with and added to the vertex arrays of the model's meshes,
+ * divisor 1. Programs without them, e.g. the one copied from the axis,
+ * draw nothing. The instance buffer is uploaded only when the trail
+ * revision changed and is reallocated only when the trail outgrew it.
+ */
+class GhostTrailRenderObject : public ifx::RenderObject {
+public:
+    /**
+     * model is the model of render_object.
+     */
+    GhostTrailRenderObject(const ifx::RenderObject& render_object,
+                           std::shared_ptr<ifx::Model> model,
+                           std::shared_ptr<ifx::Scene> scene);
+    ~GhostTrailRenderObject();
+
+    GhostTrail& ghost_trail(){return ghost_trail_;}
+    const GhostTrail& ghost_trail() const {return ghost_trail_;}
+
+    virtual void render(const Program& program) override;
+
+private:
+    static std::shared_ptr<Program> CreateProgram();
+
+    /**
+     * Points the instance attributes of program at the instance buffer,
+     * false if program has none.
+     */
+    bool BindInstanceAttributes(GLuint program);
+    void UploadInstances();
+
+    std::shared_ptr<ifx::Model> model_;
+    std::shared_ptr<ifx::Scene> scene_;
+    GhostTrail ghost_trail_;
+
+    GLuint instance_vbo_;
+    size_t instance_capacity_bytes_;
+    unsigned long long uploaded_revision_;
+
+    // Program the locations below and the vertex arrays are set up for.
+    GLuint bound_program_;
+    GLint instance_position_location_;
+    GLint instance_rotation_location_;
+    GLint model_location_;
+    GLint view_location_;
+    GLint projection_location_;
+};
+
+#endif //PROJECT_GHOST_TRAIL_RENDER_OBJECT_H
@@ -0,0 +1,28 @@
+#ifndef PROJECT_POSE_RENDER_OBJECT_H
+#define PROJECT_POSE_RENDER_OBJECT_H
+
+#include "movement_interpolation/core/pose.h"
+
+#include <object/render_object.h>
+
+/**
+ * Render object placed by a pose instead of Euler angles. update builds
+ * the model matrix straight from the quaternion, so the pose never goes
+ * through eulerAngles and rotateTo. The scale of the copied object is
+ * kept.
+ */
+class PoseRenderObject : public ifx::RenderObject {
+public:
+    PoseRenderObject(const ifx::RenderObject& render_object);
+    ~PoseRenderObject();
+
+    const Pose& pose() const {return pose_;}
+    void pose(const Pose& pose){pose_ = pose;}
+
+    virtual void update() override;
+
+private:
+    Pose pose_;
+};
+
+#endif //PROJECT_POSE_RENDER_OBJECT_H
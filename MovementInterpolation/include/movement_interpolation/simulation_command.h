@@ -0,0 +1,73 @@
+#ifndef PROJECT_SIMULATION_COMMAND_H
+#define PROJECT_SIMULATION_COMMAND_H
+
+#include "movement_interpolation/core/interpolation_data.h"
+#include "movement_interpolation/core/frame_sampler.h"
+#include "movement_interpolation/core/latency_histogram.h"
+#include "movement_interpolation/core/pose.h"
+#include "movement_interpolation/core/skeleton.h"
+
+enum class SimulationCommandType {
+    RESET,
+    SET_RUNNING,
+    SIMULATE_FRAMES,
+    CANCEL_SIMULATE_FRAMES,
+    SET_BLEND_WEIGHT
+};
+
+/**
+ * Request from the GUI, executed by the thread that owns the simulation.
+ * Holds a copy of the parameters so the GUI can keep editing its own.
+ */
+struct SimulationCommand {
+    SimulationCommandType type;
+
+    InterpolationSimulationCreateParam param;
+    bool running;
+    int frames_count;
+    FrameSamplingMode frame_sampling_mode;
+    AdaptiveTolerance adaptive_tolerance;
+    int blend_input;
+    float blend_weight;
+
+    // Ghost trail the command belongs to, see InterpolationSimulation.
+    unsigned int generation;
+};
+
+/**
+ * Everything the render thread needs from one simulation step.
+ */
+struct SimulationState {
+    bool running;
+    // Whether the current poses are shown, false after a Reset.
+    bool render_current;
+
+    float total_time;
+    float simulation_length;
+
+    glm::vec3 euler_position;
+    glm::vec3 euler_angles;
+    Pose quaternion_pose;
+    // World pose of the skeleton, empty without one. Copied between the
+    // same sized buffers, so publishing does not allocate.
+    SkeletonPose skeleton_pose;
+
+    bool simulating_frames;
+    float simulate_frames_progress;
+
+    // Measured on the simulation thread, wall clock.
+    LatencyPercentiles step_latency;
+    LatencyPercentiles simulate_frames_latency;
+    unsigned long long steps_taken;
+    unsigned long long steps_dropped;
+};
+
+/**
+ * Finished SimulateFrames samples on their way to the render thread.
+ */
+struct SimulatedFrames {
+    unsigned int generation;
+    FrameSamples samples;
+};
+
+#endif //PROJECT_SIMULATION_COMMAND_H
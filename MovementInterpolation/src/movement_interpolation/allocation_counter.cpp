@@ -0,0 +1,71 @@
+#include "movement_interpolation/allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<unsigned long long> allocation_count(0);
+
+void* CountedAllocate(std::size_t size){
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if(size == 0)
+        size = 1;
+    while(true){
+        void* memory = std::malloc(size);
+        if(memory)
+            return memory;
+        std::new_handler handler = std::get_new_handler();
+        if(!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* CountedAllocate(std::size_t size, const std::nothrow_t&) noexcept{
+    try{
+        return CountedAllocate(size);
+    }
+    catch(...){
+        return nullptr;
+    }
+}
+
+}
+
+unsigned long long AllocationCount(){
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size){
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size){
+    return CountedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t& tag) noexcept{
+    return CountedAllocate(size, tag);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept{
+    return CountedAllocate(size, tag);
+}
+
+void operator delete(void* memory) noexcept{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept{
+    std::free(memory);
+}
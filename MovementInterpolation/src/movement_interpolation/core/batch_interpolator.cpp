@@ -0,0 +1,524 @@
+#include "movement_interpolation/core/batch_interpolator.h"
+#include "movement_interpolation/core/interpolator.h"
+#include "movement_interpolation/core/spline_path.h"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+struct BatchStreams {
+    size_t count;
+    const float* t;
+    bool uniform_t;
+
+    const float* pbx; const float* pby; const float* pbz;
+    const float* pdx; const float* pdy; const float* pdz;
+    const float* ebx; const float* eby; const float* ebz;
+    const float* edx; const float* edy; const float* edz;
+    const float* q0w; const float* q0x; const float* q0y; const float* q0z;
+    const float* q1w; const float* q1x; const float* q1y; const float* q1z;
+    const float* theta; const float* inv_sin; const float* use_slerp;
+    const float* use_fast; const float* fast_a; const float* fast_b;
+
+    float* px; float* py; float* pz;
+    float* ex; float* ey; float* ez;
+    float* qw; float* qx; float* qy; float* qz;
+};
+
+// Taylor series up to x^11, error below 6e-8 on [0, pi/2].
+const float kSin3 = -1.0f / 6.0f;
+const float kSin5 = 1.0f / 120.0f;
+const float kSin7 = -1.0f / 5040.0f;
+const float kSin9 = 1.0f / 362880.0f;
+const float kSin11 = -1.0f / 39916800.0f;
+
+inline float SinPoly(float x){
+    float x2 = x * x;
+    return x * (1.0f + x2 * (kSin3 + x2 * (kSin5 + x2 * (kSin7 + x2 *
+            (kSin9 + x2 * kSin11)))));
+}
+
+void EvaluateScalar(const BatchStreams& s, size_t begin){
+    for(size_t i = begin; i < s.count; i++){
+        float t = s.uniform_t ? s.t[0] : s.t[i];
+        float omt = 1.0f - t;
+
+        s.px[i] = s.pbx[i] + s.pdx[i] * t;
+        s.py[i] = s.pby[i] + s.pdy[i] * t;
+        s.pz[i] = s.pbz[i] + s.pdz[i] * t;
+
+        s.ex[i] = s.ebx[i] + s.edx[i] * t;
+        s.ey[i] = s.eby[i] + s.edy[i] * t;
+        s.ez[i] = s.ebz[i] + s.edz[i] * t;
+
+        float w0 = omt;
+        float w1 = t;
+        if(s.use_fast[i] != 0.0f){
+            w1 = FastSlerpT(t, s.fast_a[i], s.fast_b[i]);
+            w0 = 1.0f - w1;
+        }
+        if(s.use_slerp[i] != 0.0f){
+            w0 = SinPoly(omt * s.theta[i]) * s.inv_sin[i];
+            w1 = SinPoly(t * s.theta[i]) * s.inv_sin[i];
+        }
+        float w = w0 * s.q0w[i] + w1 * s.q1w[i];
+        float x = w0 * s.q0x[i] + w1 * s.q1x[i];
+        float y = w0 * s.q0y[i] + w1 * s.q1y[i];
+        float z = w0 * s.q0z[i] + w1 * s.q1z[i];
+
+        float length = std::sqrt(w*w + x*x + y*y + z*z);
+        if(length <= 0.0f){
+            s.qw[i] = 1.0f; s.qx[i] = 0.0f; s.qy[i] = 0.0f; s.qz[i] = 0.0f;
+            continue;
+        }
+        float inv_length = 1.0f / length;
+        s.qw[i] = w * inv_length;
+        s.qx[i] = x * inv_length;
+        s.qy[i] = y * inv_length;
+        s.qz[i] = z * inv_length;
+    }
+}
+
+#if defined(__SSE2__)
+inline __m128 SinPoly(__m128 x){
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_set1_ps(kSin11);
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kSin9));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kSin7));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kSin5));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kSin3));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+    return _mm_mul_ps(p, x);
+}
+
+inline __m128 FastSlerpT(__m128 t, __m128 a, __m128 b){
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 centered = _mm_sub_ps(t, half);
+    __m128 k = _mm_add_ps(_mm_mul_ps(a, _mm_mul_ps(centered, centered)), b);
+    __m128 cubic = _mm_mul_ps(_mm_mul_ps(t, centered),
+                              _mm_sub_ps(t, _mm_set1_ps(1.0f)));
+    return _mm_add_ps(t, _mm_mul_ps(cubic, k));
+}
+
+inline __m128 Lerp4(const float* begin, const float* delta, __m128 t,
+                    size_t i){
+    return _mm_add_ps(_mm_loadu_ps(begin + i),
+                      _mm_mul_ps(_mm_loadu_ps(delta + i), t));
+}
+
+inline __m128 Blend4(const float* q0, const float* q1, __m128 w0, __m128 w1,
+                     size_t i){
+    return _mm_add_ps(_mm_mul_ps(w0, _mm_loadu_ps(q0 + i)),
+                      _mm_mul_ps(w1, _mm_loadu_ps(q1 + i)));
+}
+
+size_t EvaluateSSE(const BatchStreams& s){
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    size_t i = 0;
+    for(; i + 4 <= s.count; i += 4){
+        __m128 t = s.uniform_t ? _mm_set1_ps(s.t[0]) : _mm_loadu_ps(s.t + i);
+        __m128 omt = _mm_sub_ps(one, t);
+
+        _mm_storeu_ps(s.px + i, Lerp4(s.pbx, s.pdx, t, i));
+        _mm_storeu_ps(s.py + i, Lerp4(s.pby, s.pdy, t, i));
+        _mm_storeu_ps(s.pz + i, Lerp4(s.pbz, s.pdz, t, i));
+
+        _mm_storeu_ps(s.ex + i, Lerp4(s.ebx, s.edx, t, i));
+        _mm_storeu_ps(s.ey + i, Lerp4(s.eby, s.edy, t, i));
+        _mm_storeu_ps(s.ez + i, Lerp4(s.ebz, s.edz, t, i));
+
+        // use_* are 0 or 1, select without SSE4.1 blends.
+        __m128 use_fast = _mm_loadu_ps(s.use_fast + i);
+        __m128 fast_t = FastSlerpT(t, _mm_loadu_ps(s.fast_a + i),
+                                   _mm_loadu_ps(s.fast_b + i));
+        __m128 l1 = _mm_add_ps(t, _mm_mul_ps(use_fast, _mm_sub_ps(fast_t, t)));
+        __m128 l0 = _mm_sub_ps(one, l1);
+
+        __m128 theta = _mm_loadu_ps(s.theta + i);
+        __m128 inv_sin = _mm_loadu_ps(s.inv_sin + i);
+        __m128 use_slerp = _mm_loadu_ps(s.use_slerp + i);
+        __m128 s0 = _mm_mul_ps(SinPoly(_mm_mul_ps(omt, theta)), inv_sin);
+        __m128 s1 = _mm_mul_ps(SinPoly(_mm_mul_ps(t, theta)), inv_sin);
+        __m128 w0 = _mm_add_ps(l0, _mm_mul_ps(use_slerp, _mm_sub_ps(s0, l0)));
+        __m128 w1 = _mm_add_ps(l1, _mm_mul_ps(use_slerp, _mm_sub_ps(s1, l1)));
+
+        __m128 w = Blend4(s.q0w, s.q1w, w0, w1, i);
+        __m128 x = Blend4(s.q0x, s.q1x, w0, w1, i);
+        __m128 y = Blend4(s.q0y, s.q1y, w0, w1, i);
+        __m128 z = Blend4(s.q0z, s.q1z, w0, w1, i);
+
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(w, w), _mm_mul_ps(x, x)),
+                _mm_add_ps(_mm_mul_ps(y, y), _mm_mul_ps(z, z))));
+        __m128 valid = _mm_cmpgt_ps(length, zero);
+        __m128 inv_length = _mm_and_ps(valid, _mm_div_ps(one, length));
+
+        _mm_storeu_ps(s.qw + i, _mm_or_ps(_mm_mul_ps(w, inv_length),
+                                          _mm_andnot_ps(valid, one)));
+        _mm_storeu_ps(s.qx + i, _mm_mul_ps(x, inv_length));
+        _mm_storeu_ps(s.qy + i, _mm_mul_ps(y, inv_length));
+        _mm_storeu_ps(s.qz + i, _mm_mul_ps(z, inv_length));
+    }
+    return i;
+}
+#endif
+
+#if defined(__AVX__)
+inline __m256 SinPoly(__m256 x){
+    __m256 x2 = _mm256_mul_ps(x, x);
+    __m256 p = _mm256_set1_ps(kSin11);
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(kSin9));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(kSin7));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(kSin5));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(kSin3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(1.0f));
+    return _mm256_mul_ps(p, x);
+}
+
+inline __m256 FastSlerpT(__m256 t, __m256 a, __m256 b){
+    __m256 half = _mm256_set1_ps(0.5f);
+    __m256 centered = _mm256_sub_ps(t, half);
+    __m256 k = _mm256_add_ps(_mm256_mul_ps(a, _mm256_mul_ps(centered, centered)),
+                             b);
+    __m256 cubic = _mm256_mul_ps(_mm256_mul_ps(t, centered),
+                                 _mm256_sub_ps(t, _mm256_set1_ps(1.0f)));
+    return _mm256_add_ps(t, _mm256_mul_ps(cubic, k));
+}
+
+inline __m256 Lerp8(const float* begin, const float* delta, __m256 t,
+                    size_t i){
+    return _mm256_add_ps(_mm256_loadu_ps(begin + i),
+                         _mm256_mul_ps(_mm256_loadu_ps(delta + i), t));
+}
+
+inline __m256 Blend8(const float* q0, const float* q1, __m256 w0, __m256 w1,
+                     size_t i){
+    return _mm256_add_ps(_mm256_mul_ps(w0, _mm256_loadu_ps(q0 + i)),
+                         _mm256_mul_ps(w1, _mm256_loadu_ps(q1 + i)));
+}
+
+size_t EvaluateAVX(const BatchStreams& s){
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    size_t i = 0;
+    for(; i + 8 <= s.count; i += 8){
+        __m256 t = s.uniform_t ?
+                   _mm256_set1_ps(s.t[0]) : _mm256_loadu_ps(s.t + i);
+        __m256 omt = _mm256_sub_ps(one, t);
+
+        _mm256_storeu_ps(s.px + i, Lerp8(s.pbx, s.pdx, t, i));
+        _mm256_storeu_ps(s.py + i, Lerp8(s.pby, s.pdy, t, i));
+        _mm256_storeu_ps(s.pz + i, Lerp8(s.pbz, s.pdz, t, i));
+
+        _mm256_storeu_ps(s.ex + i, Lerp8(s.ebx, s.edx, t, i));
+        _mm256_storeu_ps(s.ey + i, Lerp8(s.eby, s.edy, t, i));
+        _mm256_storeu_ps(s.ez + i, Lerp8(s.ebz, s.edz, t, i));
+
+        __m256 use_fast = _mm256_cmp_ps(_mm256_loadu_ps(s.use_fast + i),
+                                        zero, _CMP_NEQ_OQ);
+        __m256 fast_t = FastSlerpT(t, _mm256_loadu_ps(s.fast_a + i),
+                                   _mm256_loadu_ps(s.fast_b + i));
+        __m256 l1 = _mm256_blendv_ps(t, fast_t, use_fast);
+        __m256 l0 = _mm256_sub_ps(one, l1);
+
+        __m256 theta = _mm256_loadu_ps(s.theta + i);
+        __m256 inv_sin = _mm256_loadu_ps(s.inv_sin + i);
+        __m256 use_slerp = _mm256_cmp_ps(_mm256_loadu_ps(s.use_slerp + i),
+                                         zero, _CMP_NEQ_OQ);
+        __m256 s0 = _mm256_mul_ps(SinPoly(_mm256_mul_ps(omt, theta)), inv_sin);
+        __m256 s1 = _mm256_mul_ps(SinPoly(_mm256_mul_ps(t, theta)), inv_sin);
+        __m256 w0 = _mm256_blendv_ps(l0, s0, use_slerp);
+        __m256 w1 = _mm256_blendv_ps(l1, s1, use_slerp);
+
+        __m256 w = Blend8(s.q0w, s.q1w, w0, w1, i);
+        __m256 x = Blend8(s.q0x, s.q1x, w0, w1, i);
+        __m256 y = Blend8(s.q0y, s.q1y, w0, w1, i);
+        __m256 z = Blend8(s.q0z, s.q1z, w0, w1, i);
+
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(w, w), _mm256_mul_ps(x, x)),
+                _mm256_add_ps(_mm256_mul_ps(y, y), _mm256_mul_ps(z, z))));
+        __m256 valid = _mm256_cmp_ps(length, zero, _CMP_GT_OQ);
+        __m256 inv_length = _mm256_and_ps(valid, _mm256_div_ps(one, length));
+
+        _mm256_storeu_ps(s.qw + i, _mm256_blendv_ps(
+                one, _mm256_mul_ps(w, inv_length), valid));
+        _mm256_storeu_ps(s.qx + i, _mm256_mul_ps(x, inv_length));
+        _mm256_storeu_ps(s.qy + i, _mm256_mul_ps(y, inv_length));
+        _mm256_storeu_ps(s.qz + i, _mm256_mul_ps(z, inv_length));
+    }
+    return i;
+}
+#endif
+
+}
+
+void BatchPoses::Resize(size_t count){
+    position_x.resize(count);
+    position_y.resize(count);
+    position_z.resize(count);
+    euler_x.resize(count);
+    euler_y.resize(count);
+    euler_z.resize(count);
+    quaternion_w.resize(count);
+    quaternion_x.resize(count);
+    quaternion_y.resize(count);
+    quaternion_z.resize(count);
+}
+
+glm::vec3 BatchPoses::Position(size_t i) const{
+    return glm::vec3(position_x[i], position_y[i], position_z[i]);
+}
+
+glm::vec3 BatchPoses::EulerAngles(size_t i) const{
+    return glm::vec3(euler_x[i], euler_y[i], euler_z[i]);
+}
+
+glm::quat BatchPoses::Quaternion(size_t i) const{
+    return glm::quat(quaternion_w[i], quaternion_x[i],
+                     quaternion_y[i], quaternion_z[i]);
+}
+
+BatchInterpolator::BatchInterpolator() :
+        kernel_(BestKernel()){}
+
+BatchInterpolator::~BatchInterpolator(){}
+
+void BatchInterpolator::kernel(BatchKernel kernel){
+    kernel_ = kernel;
+#if !defined(__AVX__)
+    if(kernel_ == BatchKernel::AVX)
+        kernel_ = BatchKernel::SSE;
+#endif
+#if !defined(__SSE2__)
+    if(kernel_ == BatchKernel::SSE)
+        kernel_ = BatchKernel::SCALAR;
+#endif
+}
+
+BatchKernel BatchInterpolator::BestKernel(){
+#if defined(__AVX__)
+    return BatchKernel::AVX;
+#elif defined(__SSE2__)
+    return BatchKernel::SSE;
+#else
+    return BatchKernel::SCALAR;
+#endif
+}
+
+const char* BatchInterpolator::KernelName(BatchKernel kernel){
+    switch(kernel){
+        case BatchKernel::SCALAR:
+            return "scalar";
+        case BatchKernel::SSE:
+            return "sse2";
+        case BatchKernel::AVX:
+            return "avx";
+    }
+    return "unknown";
+}
+
+template<class F>
+void BatchInterpolator::ForEachStream(F f){
+    std::vector<float>* streams[] = {
+            &position_begin_x_, &position_begin_y_, &position_begin_z_,
+            &position_delta_x_, &position_delta_y_, &position_delta_z_,
+            &euler_begin_x_, &euler_begin_y_, &euler_begin_z_,
+            &euler_delta_x_, &euler_delta_y_, &euler_delta_z_,
+            &quaternion_begin_w_, &quaternion_begin_x_,
+            &quaternion_begin_y_, &quaternion_begin_z_,
+            &quaternion_end_w_, &quaternion_end_x_,
+            &quaternion_end_y_, &quaternion_end_z_,
+            &theta_, &inv_sin_theta_, &use_slerp_,
+            &use_fast_slerp_, &fast_slerp_a_, &fast_slerp_b_};
+    for(auto stream : streams)
+        f(*stream);
+}
+
+void BatchInterpolator::Reserve(size_t count){
+    method_.reserve(count);
+    ForEachStream([count](std::vector<float>& stream){
+        stream.reserve(count);
+    });
+}
+
+void BatchInterpolator::Clear(){
+    method_.clear();
+    path_tracks_.clear();
+    paths_.clear();
+    ForEachStream([](std::vector<float>& stream){
+        stream.clear();
+    });
+}
+
+size_t BatchInterpolator::AddTrack(const InterpolationData& data){
+    if(data.position_path){
+        path_tracks_.push_back(size());
+        paths_.push_back(data.position_path);
+    }
+    glm::vec3 position_delta = data.position_end - data.position_begin;
+    glm::vec3 euler_delta = data.euler_end - data.euler_begin;
+
+    position_begin_x_.push_back(data.position_begin.x);
+    position_begin_y_.push_back(data.position_begin.y);
+    position_begin_z_.push_back(data.position_begin.z);
+    position_delta_x_.push_back(position_delta.x);
+    position_delta_y_.push_back(position_delta.y);
+    position_delta_z_.push_back(position_delta.z);
+
+    euler_begin_x_.push_back(data.euler_begin.x);
+    euler_begin_y_.push_back(data.euler_begin.y);
+    euler_begin_z_.push_back(data.euler_begin.z);
+    euler_delta_x_.push_back(euler_delta.x);
+    euler_delta_y_.push_back(euler_delta.y);
+    euler_delta_z_.push_back(euler_delta.z);
+
+    glm::quat end = data.quaternion_end;
+    float theta = 0.0f;
+    float inv_sin_theta = 0.0f;
+    float use_slerp = 0.0f;
+    float use_fast_slerp = 0.0f;
+    float fast_slerp_a = 0.0f;
+    float fast_slerp_b = 0.0f;
+    if(data.interpolation_method != InterpolationMethod::LERP){
+        float cos_theta = glm::dot(data.quaternion_begin, end);
+        if(cos_theta < 0.0f){
+            end = -end;
+            cos_theta = -cos_theta;
+        }
+        if(data.interpolation_method == InterpolationMethod::FAST_SLERP){
+            FastSlerpCoefficients(cos_theta, fast_slerp_a, fast_slerp_b);
+            use_fast_slerp = 1.0f;
+        }
+        // Same threshold as glm::slerp, falls back to linear weights.
+        else if(cos_theta <= 1.0f - glm::epsilon<float>()){
+            theta = std::acos(cos_theta);
+            inv_sin_theta = 1.0f / std::sin(theta);
+            use_slerp = 1.0f;
+        }
+    }
+
+    quaternion_begin_w_.push_back(data.quaternion_begin.w);
+    quaternion_begin_x_.push_back(data.quaternion_begin.x);
+    quaternion_begin_y_.push_back(data.quaternion_begin.y);
+    quaternion_begin_z_.push_back(data.quaternion_begin.z);
+    quaternion_end_w_.push_back(end.w);
+    quaternion_end_x_.push_back(end.x);
+    quaternion_end_y_.push_back(end.y);
+    quaternion_end_z_.push_back(end.z);
+
+    theta_.push_back(theta);
+    inv_sin_theta_.push_back(inv_sin_theta);
+    use_slerp_.push_back(use_slerp);
+    use_fast_slerp_.push_back(use_fast_slerp);
+    fast_slerp_a_.push_back(fast_slerp_a);
+    fast_slerp_b_.push_back(fast_slerp_b);
+
+    method_.push_back(data.interpolation_method);
+    return method_.size() - 1;
+}
+
+void BatchInterpolator::Evaluate(float t, BatchPoses& poses) const{
+    Evaluate(&t, true, poses);
+}
+
+void BatchInterpolator::Evaluate(const float* t, BatchPoses& poses) const{
+    Evaluate(t, false, poses);
+}
+
+void BatchInterpolator::Evaluate(const float* t, bool uniform_t,
+                                 BatchPoses& poses) const{
+    poses.Resize(size());
+
+    BatchStreams s;
+    s.count = size();
+    s.t = t;
+    s.uniform_t = uniform_t;
+    s.pbx = position_begin_x_.data();
+    s.pby = position_begin_y_.data();
+    s.pbz = position_begin_z_.data();
+    s.pdx = position_delta_x_.data();
+    s.pdy = position_delta_y_.data();
+    s.pdz = position_delta_z_.data();
+    s.ebx = euler_begin_x_.data();
+    s.eby = euler_begin_y_.data();
+    s.ebz = euler_begin_z_.data();
+    s.edx = euler_delta_x_.data();
+    s.edy = euler_delta_y_.data();
+    s.edz = euler_delta_z_.data();
+    s.q0w = quaternion_begin_w_.data();
+    s.q0x = quaternion_begin_x_.data();
+    s.q0y = quaternion_begin_y_.data();
+    s.q0z = quaternion_begin_z_.data();
+    s.q1w = quaternion_end_w_.data();
+    s.q1x = quaternion_end_x_.data();
+    s.q1y = quaternion_end_y_.data();
+    s.q1z = quaternion_end_z_.data();
+    s.theta = theta_.data();
+    s.inv_sin = inv_sin_theta_.data();
+    s.use_slerp = use_slerp_.data();
+    s.use_fast = use_fast_slerp_.data();
+    s.fast_a = fast_slerp_a_.data();
+    s.fast_b = fast_slerp_b_.data();
+    s.px = poses.position_x.data();
+    s.py = poses.position_y.data();
+    s.pz = poses.position_z.data();
+    s.ex = poses.euler_x.data();
+    s.ey = poses.euler_y.data();
+    s.ez = poses.euler_z.data();
+    s.qw = poses.quaternion_w.data();
+    s.qx = poses.quaternion_x.data();
+    s.qy = poses.quaternion_y.data();
+    s.qz = poses.quaternion_z.data();
+
+    size_t done = 0;
+#if defined(__AVX__)
+    if(kernel_ == BatchKernel::AVX)
+        done = EvaluateAVX(s);
+#endif
+#if defined(__SSE2__)
+    if(kernel_ != BatchKernel::SCALAR){
+        BatchStreams tail = s;
+        // SSE kernel indexes from 0, offset every stream to the tail.
+        if(done > 0){
+            tail.count = s.count - done;
+            tail.t = uniform_t ? s.t : s.t + done;
+            const float** in[] = {
+                    &tail.pbx, &tail.pby, &tail.pbz,
+                    &tail.pdx, &tail.pdy, &tail.pdz,
+                    &tail.ebx, &tail.eby, &tail.ebz,
+                    &tail.edx, &tail.edy, &tail.edz,
+                    &tail.q0w, &tail.q0x, &tail.q0y, &tail.q0z,
+                    &tail.q1w, &tail.q1x, &tail.q1y, &tail.q1z,
+                    &tail.theta, &tail.inv_sin, &tail.use_slerp,
+                    &tail.use_fast, &tail.fast_a, &tail.fast_b};
+            for(auto stream : in)
+                *stream += done;
+            float** out[] = {
+                    &tail.px, &tail.py, &tail.pz,
+                    &tail.ex, &tail.ey, &tail.ez,
+                    &tail.qw, &tail.qx, &tail.qy, &tail.qz};
+            for(auto stream : out)
+                *stream += done;
+        }
+        done += EvaluateSSE(tail);
+    }
+#endif
+    EvaluateScalar(s, done);
+
+    for(size_t i = 0; i < path_tracks_.size(); i++){
+        size_t track = path_tracks_[i];
+        glm::vec3 position = paths_[i]->Evaluate(uniform_t ? t[0] : t[track]);
+        poses.position_x[track] = position.x;
+        poses.position_y[track] = position.y;
+        poses.position_z[track] = position.z;
+    }
+}
@@ -0,0 +1,158 @@
+#include "movement_interpolation/core/batch_job.h"
+#include "movement_interpolation/core/interpolator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const int kRequiredFloats = 12;
+const int kQuaternionFloats = 8;
+
+bool ParseMethod(const char*& cursor, InterpolationMethod& method){
+    while(*cursor == ' ' || *cursor == '\t')
+        cursor++;
+    const char* end = cursor;
+    while(*end && *end != ' ' && *end != '\t')
+        end++;
+    std::string name(cursor, end);
+    cursor = end;
+    if(name == "lerp")
+        method = InterpolationMethod::LERP;
+    else if(name == "slerp")
+        method = InterpolationMethod::SLERP;
+    else if(name == "fast_slerp")
+        method = InterpolationMethod::FAST_SLERP;
+    else
+        return false;
+    return true;
+}
+
+/**
+ * Reads up to max_count floats, returns how many were read.
+ */
+int ParseFloats(const char*& cursor, float* values, int max_count){
+    int count = 0;
+    while(count < max_count){
+        char* end;
+        float value = std::strtof(cursor, &end);
+        if(end == cursor)
+            break;
+        values[count++] = value;
+        cursor = end;
+    }
+    return count;
+}
+
+bool IsBlank(const char* cursor){
+    while(*cursor == ' ' || *cursor == '\t' || *cursor == '\r')
+        cursor++;
+    return *cursor == '\0';
+}
+
+}
+
+bool ParseBatchJob(const std::string& line, BatchJob& job,
+                   std::string& error){
+    const char* cursor = line.c_str();
+    InterpolationData& data = job.param.interpolation_data;
+    if(!ParseMethod(cursor, data.interpolation_method)){
+        error = "unknown interpolation method";
+        return false;
+    }
+    char* end;
+    job.param.simulation_length_s = std::strtof(cursor, &end);
+    if(end == cursor || job.param.simulation_length_s <= 0.0f){
+        error = "expected a positive length";
+        return false;
+    }
+    cursor = end;
+    long frames_count = std::strtol(cursor, &end, 10);
+    if(end == cursor || frames_count <= 0){
+        error = "expected a positive frame count";
+        return false;
+    }
+    if(frames_count > kMaxBatchJobFrames){
+        error = "frame count above " + std::to_string(kMaxBatchJobFrames);
+        return false;
+    }
+    job.frames_count = (int)frames_count;
+    cursor = end;
+
+    float values[kRequiredFloats + kQuaternionFloats];
+    int count = ParseFloats(cursor, values,
+                            kRequiredFloats + kQuaternionFloats);
+    if((count != kRequiredFloats
+        && count != kRequiredFloats + kQuaternionFloats)
+       || !IsBlank(cursor)){
+        error = "expected 12 or 20 numbers after the frame count";
+        return false;
+    }
+    data.position_begin = glm::vec3(values[0], values[1], values[2]);
+    data.position_end = glm::vec3(values[3], values[4], values[5]);
+    data.euler_begin = glm::vec3(values[6], values[7], values[8]);
+    data.euler_end = glm::vec3(values[9], values[10], values[11]);
+    data.position_path.reset();
+    if(count == kRequiredFloats){
+        data.quaternion_begin = glm::quat(glm::radians(data.euler_begin));
+        data.quaternion_end = glm::quat(glm::radians(data.euler_end));
+    }
+    else{
+        data.quaternion_begin = glm::quat(values[12], values[13],
+                                          values[14], values[15]);
+        data.quaternion_end = glm::quat(values[16], values[17],
+                                        values[18], values[19]);
+    }
+    data.quaternion_begin = glm::normalize(data.quaternion_begin);
+    data.quaternion_end = glm::normalize(data.quaternion_end);
+    return true;
+}
+
+bool ReadBatchJobs(std::istream& input, size_t max_count,
+                   std::vector<BatchJob>& jobs, size_t& line_number,
+                   std::string& error){
+    std::string line;
+    size_t read = 0;
+    BatchJob job;
+    while(read < max_count && std::getline(input, line)){
+        line_number++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if(first == std::string::npos || line[first] == '#')
+            continue;
+        if(!ParseBatchJob(line, job, error)){
+            error = "line " + std::to_string(line_number) + ": " + error;
+            return false;
+        }
+        jobs.push_back(job);
+        read++;
+    }
+    return true;
+}
+
+DivergenceStats RunBatchJob(const BatchJob& job, FrameSamples& samples){
+    Interpolator interpolator(job.param.interpolation_data);
+    FrameSampler::Sample(interpolator, job.frames_count, samples);
+
+    DivergenceStats stats = DivergenceStats();
+    double sum = 0.0;
+    double square_sum = 0.0;
+    for(size_t i = 0; i < samples.size(); i++){
+        glm::quat euler_rotation = glm::quat(
+                glm::radians(samples.euler_angles[i]));
+        float angle = AngleDegrees(euler_rotation, samples.quaternions[i]);
+        sum += angle;
+        square_sum += (double)angle * angle;
+        if(angle > stats.max_degrees){
+            stats.max_degrees = angle;
+            stats.max_time = (float)i / (float)job.frames_count
+                             * job.param.simulation_length_s;
+        }
+    }
+    if(samples.size() > 0){
+        stats.mean_degrees = (float)(sum / samples.size());
+        stats.rms_degrees = (float)std::sqrt(square_sum / samples.size());
+    }
+    return stats;
+}
@@ -0,0 +1,177 @@
+#include "movement_interpolation/core/bvh_loader.h"
+
+#include <fstream>
+
+namespace {
+
+enum class Channel {
+    X_POSITION, Y_POSITION, Z_POSITION,
+    X_ROTATION, Y_ROTATION, Z_ROTATION
+};
+
+struct Joint {
+    glm::vec3 offset;
+    std::vector<Channel> channels;
+};
+
+bool ParseChannel(const std::string& name, Channel& channel){
+    static const char* names[] = {"Xposition", "Yposition", "Zposition",
+                                  "Xrotation", "Yrotation", "Zrotation"};
+    for(int i = 0; i < 6; i++){
+        if(name == names[i]){
+            channel = (Channel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Expect(std::istream& input, const std::string& token,
+            std::string& error){
+    std::string read;
+    if(!(input >> read) || read != token){
+        error = "expected " + token + ", got " + read;
+        return false;
+    }
+    return true;
+}
+
+bool ParseHierarchy(std::istream& input,
+                    std::vector<NamedKeyframeTrack>& tracks,
+                    std::vector<Joint>& joints,
+                    std::string& error){
+    std::vector<int> parents;
+    std::string token;
+    // End Sites have no channels, they only need their braces matched.
+    int end_site_depth = 0;
+    while(input >> token){
+        if(token == "MOTION")
+            return true;
+        if(token == "ROOT" || token == "JOINT"){
+            NamedKeyframeTrack track;
+            input >> track.name;
+            track.parent = parents.empty() ? -1 : parents.back();
+            track.track = std::make_shared<KeyframeTrack>();
+            tracks.push_back(track);
+            joints.push_back(Joint());
+            parents.push_back((int)tracks.size() - 1);
+            if(!Expect(input, "{", error))
+                return false;
+        }
+        else if(token == "End"){
+            input >> token;
+            if(!Expect(input, "{", error))
+                return false;
+            end_site_depth++;
+        }
+        else if(token == "OFFSET"){
+            glm::vec3 offset;
+            input >> offset.x >> offset.y >> offset.z;
+            if(end_site_depth == 0 && !joints.empty())
+                joints.back().offset = offset;
+        }
+        else if(token == "CHANNELS"){
+            if(joints.empty()){
+                error = "CHANNELS outside of a joint";
+                return false;
+            }
+            int count = 0;
+            input >> count;
+            for(int i = 0; i < count; i++){
+                Channel channel;
+                if(!(input >> token) || !ParseChannel(token, channel)){
+                    error = "unknown channel " + token;
+                    return false;
+                }
+                joints.back().channels.push_back(channel);
+            }
+        }
+        else if(token == "}"){
+            if(end_site_depth > 0)
+                end_site_depth--;
+            else if(!parents.empty())
+                parents.pop_back();
+        }
+    }
+    error = "missing MOTION section";
+    return false;
+}
+
+}
+
+bool LoadBvh(const std::string& path,
+             std::vector<NamedKeyframeTrack>& tracks,
+             std::string& error){
+    tracks.clear();
+    std::ifstream input(path);
+    if(!input){
+        error = "Could not open " + path;
+        return false;
+    }
+    std::vector<Joint> joints;
+    if(!Expect(input, "HIERARCHY", error) ||
+       !ParseHierarchy(input, tracks, joints, error)){
+        error = path + ": " + error;
+        return false;
+    }
+
+    int frame_count = 0;
+    float frame_time = 0.0f;
+    std::string token;
+    if(!Expect(input, "Frames:", error) || !(input >> frame_count) ||
+       !Expect(input, "Frame", error) || !Expect(input, "Time:", error) ||
+       !(input >> frame_time)){
+        error = path + ": invalid MOTION header " + error;
+        return false;
+    }
+    if(frame_count < 0 || frame_time < 0.0f){
+        error = path + ": negative frame count or frame time";
+        return false;
+    }
+
+    for(NamedKeyframeTrack& track : tracks)
+        track.track->Reserve(frame_count);
+
+    for(int frame = 0; frame < frame_count; frame++){
+        for(size_t j = 0; j < joints.size(); j++){
+            Keyframe key;
+            key.time = frame * frame_time;
+            key.position = joints[j].offset;
+            key.rotation = glm::quat(1, 0, 0, 0);
+            for(Channel channel : joints[j].channels){
+                float value;
+                if(!(input >> value)){
+                    error = path + ": frame " + std::to_string(frame)
+                            + " is truncated";
+                    return false;
+                }
+                switch(channel){
+                    case Channel::X_POSITION:
+                        key.position.x += value;
+                        break;
+                    case Channel::Y_POSITION:
+                        key.position.y += value;
+                        break;
+                    case Channel::Z_POSITION:
+                        key.position.z += value;
+                        break;
+                    case Channel::X_ROTATION:
+                        key.rotation = key.rotation * glm::angleAxis(
+                                glm::radians(value), glm::vec3(1, 0, 0));
+                        break;
+                    case Channel::Y_ROTATION:
+                        key.rotation = key.rotation * glm::angleAxis(
+                                glm::radians(value), glm::vec3(0, 1, 0));
+                        break;
+                    case Channel::Z_ROTATION:
+                        key.rotation = key.rotation * glm::angleAxis(
+                                glm::radians(value), glm::vec3(0, 0, 1));
+                        break;
+                }
+            }
+            key.rotation = glm::normalize(key.rotation);
+            tracks[j].track->AddKey(key);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,17 @@
+#include "movement_interpolation/core/clock.h"
+
+WallClock::WallClock() :
+        start_(std::chrono::steady_clock::now()){}
+
+WallClock::~WallClock(){}
+
+double WallClock::Now(){
+    std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start_;
+    return elapsed.count();
+}
+
+ManualClock::ManualClock(double time) :
+        time_(time){}
+
+ManualClock::~ManualClock(){}
@@ -0,0 +1,386 @@
+#include "movement_interpolation/core/compressed_keyframe_track.h"
+#include "movement_interpolation/core/interpolator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const float kSqrt2 = 1.41421356f;
+const uint32_t kTimeSteps = 0xFFFF;
+// Evenly spaced times may be off by this fraction of the spacing.
+const float kUniformTimeTolerance = 1e-4f;
+
+uint32_t Quantize(float value, float min, float scale, uint32_t max){
+    if(scale <= 0.0f)
+        return 0;
+    float steps = (value - min) / scale + 0.5f;
+    if(steps <= 0.0f)
+        return 0;
+    return std::min((uint32_t)steps, max);
+}
+
+uint32_t QuantizeUnit(float value, int bits){
+    uint32_t max = (1u << bits) - 1;
+    float unit = glm::clamp(value * kSqrt2 * 0.5f + 0.5f, 0.0f, 1.0f);
+    return (uint32_t)(unit * (float)max + 0.5f);
+}
+
+float DequantizeUnit(uint32_t value, int bits){
+    float max = (float)((1u << bits) - 1);
+    return ((float)value / max * 2.0f - 1.0f) / kSqrt2;
+}
+
+/**
+ * Index of the largest component in x, y, z, w order and the other three
+ * with the sign flipped so the dropped one is positive.
+ */
+uint32_t SmallestThree(const glm::quat& q, float smallest[3]){
+    float components[4] = {q.x, q.y, q.z, q.w};
+    uint32_t largest = 0;
+    for(uint32_t i = 1; i < 4; i++){
+        if(std::abs(components[i]) > std::abs(components[largest]))
+            largest = i;
+    }
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+    for(uint32_t i = 0, j = 0; i < 4; i++){
+        if(i != largest)
+            smallest[j++] = components[i] * sign;
+    }
+    return largest;
+}
+
+// Components kept next to each dropped one, in x, y, z, w order.
+const uint32_t kSmallestThree[4][3] = {
+        {1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+
+glm::quat FromSmallestThree(uint32_t largest, const float smallest[3]){
+    float components[4];
+    const uint32_t* order = kSmallestThree[largest];
+    components[order[0]] = smallest[0];
+    components[order[1]] = smallest[1];
+    components[order[2]] = smallest[2];
+    float sum = smallest[0] * smallest[0] + smallest[1] * smallest[1]
+                + smallest[2] * smallest[2];
+    components[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+    return glm::quat(components[3], components[0], components[1],
+                     components[2]);
+}
+
+uint32_t Align(std::vector<uint8_t>& data){
+    data.resize((data.size() + 3) & ~(size_t)3);
+    return (uint32_t)data.size();
+}
+
+template<class T>
+void Append(std::vector<uint8_t>& data, const T& value){
+    size_t offset = data.size();
+    data.resize(offset + sizeof(T));
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+glm::quat Hemisphere(const glm::quat& q, const glm::quat& reference){
+    return glm::dot(q, reference) < 0.0f ? -q : q;
+}
+
+}
+
+const size_t CompressedKeyframeTrack::kBlockSize;
+const uint32_t CompressedKeyframeTrack::kOmitted;
+
+CompressedKeyframeTrack::CompressedKeyframeTrack() :
+        compression_(KeyframeCompression::HIGH),
+        interpolation_method_(KeyframeInterpolationMethod::SLERP),
+        size_(0),
+        cursor_(0){}
+
+CompressedKeyframeTrack::~CompressedKeyframeTrack(){}
+
+void CompressedKeyframeTrack::Compress(const KeyframeTrack& track,
+                                       KeyframeCompression compression){
+    compression_ = compression;
+    interpolation_method_ = track.interpolation_method();
+    size_ = track.size();
+    data_.clear();
+    cursor_ = 0;
+    // The block headers come first, the key data follows.
+    size_t block_count = (size_ + kBlockSize - 1) / kBlockSize;
+    data_.resize(block_count * sizeof(Block));
+
+    const Keyframe* keys = track.keys();
+    for(size_t first = 0; first < size_; first += kBlockSize){
+        size_t count = std::min(kBlockSize, size_ - first);
+        const Keyframe* block_keys = keys + first;
+        Block block;
+
+        float time_begin = block_keys[0].time;
+        float time_end = block_keys[count - 1].time;
+        float spacing = count > 1 ? (time_end - time_begin) / (count - 1)
+                                  : 0.0f;
+        bool uniform = true;
+        for(size_t i = 0; i < count && uniform; i++){
+            float expected = time_begin + spacing * i;
+            uniform = std::abs(block_keys[i].time - expected)
+                      <= kUniformTimeTolerance * spacing;
+        }
+        block.time_begin = time_begin;
+        if(uniform){
+            block.time_scale = spacing;
+            block.times_offset = kOmitted;
+        }
+        else{
+            block.time_scale = (time_end - time_begin) / kTimeSteps;
+            block.times_offset = Align(data_);
+            for(size_t i = 0; i < count; i++){
+                Append(data_, (uint16_t)Quantize(block_keys[i].time,
+                                                 time_begin,
+                                                 block.time_scale,
+                                                 kTimeSteps));
+            }
+        }
+
+        glm::vec3 position_min = block_keys[0].position;
+        glm::vec3 position_max = block_keys[0].position;
+        for(size_t i = 1; i < count; i++){
+            position_min = glm::min(position_min, block_keys[i].position);
+            position_max = glm::max(position_max, block_keys[i].position);
+        }
+        block.position_min = position_min;
+        block.position_scale = glm::vec3(0, 0, 0);
+        block.positions_offset = kOmitted;
+        if(position_min != position_max){
+            glm::vec3 extent = position_max - position_min;
+            block.positions_offset = Align(data_);
+            if(compression_ == KeyframeCompression::HIGH){
+                block.position_scale = extent / (float)0xFFFF;
+                for(size_t i = 0; i < count; i++){
+                    for(int axis = 0; axis < 3; axis++){
+                        Append(data_, (uint16_t)Quantize(
+                                block_keys[i].position[axis],
+                                position_min[axis],
+                                block.position_scale[axis], 0xFFFF));
+                    }
+                }
+            }
+            else{
+                block.position_scale = extent * glm::vec3(
+                        1.0f / 0x7FF, 1.0f / 0x7FF, 1.0f / 0x3FF);
+                for(size_t i = 0; i < count; i++){
+                    const glm::vec3& p = block_keys[i].position;
+                    uint32_t packed
+                            = Quantize(p.x, position_min.x,
+                                       block.position_scale.x, 0x7FF) << 21
+                            | Quantize(p.y, position_min.y,
+                                       block.position_scale.y, 0x7FF) << 10
+                            | Quantize(p.z, position_min.z,
+                                       block.position_scale.z, 0x3FF);
+                    Append(data_, packed);
+                }
+            }
+        }
+
+        block.rotations_offset = Align(data_);
+        for(size_t i = 0; i < count; i++){
+            float smallest[3];
+            uint32_t largest = SmallestThree(
+                    glm::normalize(block_keys[i].rotation), smallest);
+            if(compression_ == KeyframeCompression::HIGH){
+                uint64_t packed = (uint64_t)largest << 45
+                        | (uint64_t)QuantizeUnit(smallest[0], 15) << 30
+                        | (uint64_t)QuantizeUnit(smallest[1], 15) << 15
+                        | (uint64_t)QuantizeUnit(smallest[2], 15);
+                Append(data_, (uint16_t)(packed >> 32));
+                Append(data_, (uint16_t)(packed >> 16));
+                Append(data_, (uint16_t)packed);
+            }
+            else{
+                uint32_t packed = largest << 30
+                        | QuantizeUnit(smallest[0], 10) << 20
+                        | QuantizeUnit(smallest[1], 10) << 10
+                        | QuantizeUnit(smallest[2], 10);
+                Append(data_, packed);
+            }
+        }
+        std::memcpy(data_.data() + first / kBlockSize * sizeof(Block),
+                    &block, sizeof(Block));
+    }
+    data_.shrink_to_fit();
+}
+
+void CompressedKeyframeTrack::Decompress(KeyframeTrack& track) const{
+    track.Clear();
+    track.interpolation_method(interpolation_method_);
+    track.Reserve(size_);
+    for(size_t i = 0; i < size_; i++)
+        track.AddKey(key(i));
+}
+
+float CompressedKeyframeTrack::start_time() const{
+    return size_ == 0 ? 0.0f : key_time(0);
+}
+
+float CompressedKeyframeTrack::end_time() const{
+    return size_ == 0 ? 0.0f : key_time(size_ - 1);
+}
+
+size_t CompressedKeyframeTrack::size_bytes() const{
+    return data_.size();
+}
+
+Keyframe CompressedKeyframeTrack::key(size_t index) const{
+    const Block& block = blocks()[index / kBlockSize];
+    size_t block_index = index % kBlockSize;
+    Keyframe key;
+    key.time = key_time(index);
+    key.position = DecodePosition(block, block_index);
+    key.rotation = DecodeRotation(block, block_index);
+    return key;
+}
+
+float CompressedKeyframeTrack::key_time(size_t index) const{
+    const Block& block = blocks()[index / kBlockSize];
+    size_t block_index = index % kBlockSize;
+    if(block.times_offset == kOmitted)
+        return block.time_begin + block.time_scale * block_index;
+    const uint16_t* times = reinterpret_cast<const uint16_t*>(
+            data_.data() + block.times_offset);
+    return block.time_begin + block.time_scale * times[block_index];
+}
+
+glm::vec3 CompressedKeyframeTrack::DecodePosition(const Block& block,
+                                                  size_t index) const{
+    if(block.positions_offset == kOmitted)
+        return block.position_min;
+    const uint8_t* positions = data_.data() + block.positions_offset;
+    glm::vec3 quantized;
+    if(compression_ == KeyframeCompression::HIGH){
+        const uint16_t* p = reinterpret_cast<const uint16_t*>(positions)
+                            + index * 3;
+        quantized = glm::vec3(p[0], p[1], p[2]);
+    }
+    else{
+        uint32_t p = reinterpret_cast<const uint32_t*>(positions)[index];
+        quantized = glm::vec3(p >> 21, (p >> 10) & 0x7FF, p & 0x3FF);
+    }
+    return block.position_min + quantized * block.position_scale;
+}
+
+glm::quat CompressedKeyframeTrack::DecodeRotation(const Block& block,
+                                                  size_t index) const{
+    const uint8_t* rotations = data_.data() + block.rotations_offset;
+    float smallest[3];
+    uint32_t largest;
+    if(compression_ == KeyframeCompression::HIGH){
+        const uint16_t* r = reinterpret_cast<const uint16_t*>(rotations)
+                            + index * 3;
+        uint64_t packed = (uint64_t)r[0] << 32 | (uint64_t)r[1] << 16 | r[2];
+        largest = (uint32_t)(packed >> 45) & 3;
+        smallest[0] = DequantizeUnit((uint32_t)(packed >> 30) & 0x7FFF, 15);
+        smallest[1] = DequantizeUnit((uint32_t)(packed >> 15) & 0x7FFF, 15);
+        smallest[2] = DequantizeUnit((uint32_t)packed & 0x7FFF, 15);
+    }
+    else{
+        uint32_t packed = reinterpret_cast<const uint32_t*>(rotations)[index];
+        largest = packed >> 30;
+        smallest[0] = DequantizeUnit((packed >> 20) & 0x3FF, 10);
+        smallest[1] = DequantizeUnit((packed >> 10) & 0x3FF, 10);
+        smallest[2] = DequantizeUnit(packed & 0x3FF, 10);
+    }
+    return FromSmallestThree(largest, smallest);
+}
+
+void CompressedKeyframeTrack::Evaluate(float time, glm::vec3& position,
+                                       glm::quat& rotation) const{
+    if(size_ == 0){
+        position = glm::vec3(0,0,0);
+        rotation = glm::quat(1,0,0,0);
+        return;
+    }
+    if(size_ == 1){
+        Keyframe only = key(0);
+        position = only.position;
+        rotation = only.rotation;
+        return;
+    }
+    size_t segment = FindSegment(time);
+    const Block& begin_block = blocks()[segment / kBlockSize];
+    const Block& end_block = blocks()[(segment + 1) / kBlockSize];
+    size_t begin_index = segment % kBlockSize;
+    size_t end_index = (segment + 1) % kBlockSize;
+
+    float begin_time = key_time(segment);
+    float length = key_time(segment + 1) - begin_time;
+    float t = length <= 0.0f ? 0.0f
+              : glm::clamp((time - begin_time) / length, 0.0f, 1.0f);
+
+    glm::vec3 begin_position = DecodePosition(begin_block, begin_index);
+    glm::vec3 end_position = DecodePosition(end_block, end_index);
+    position = begin_position + (end_position - begin_position) * t;
+
+    glm::quat begin_rotation = DecodeRotation(begin_block, begin_index);
+    glm::quat end_rotation = Hemisphere(
+            DecodeRotation(end_block, end_index), begin_rotation);
+    if(interpolation_method_ == KeyframeInterpolationMethod::LERP)
+        rotation = glm::normalize(glm::lerp(begin_rotation, end_rotation, t));
+    else
+        rotation = glm::normalize(glm::slerp(begin_rotation, end_rotation, t));
+}
+
+size_t CompressedKeyframeTrack::FindSegment(float time) const{
+    size_t last_segment = size_ - 2;
+    if(cursor_ > last_segment)
+        cursor_ = last_segment;
+
+    // Same segment or the next one during forward playback.
+    if(key_time(cursor_) <= time){
+        if(cursor_ == last_segment || time < key_time(cursor_ + 1))
+            return cursor_;
+        if(cursor_ + 1 == last_segment || time < key_time(cursor_ + 2))
+            return ++cursor_;
+    }
+
+    // Block by its first key, then the key within the block.
+    const Block* blocks_begin = blocks();
+    const Block* blocks_end = blocks_begin
+                              + (size_ + kBlockSize - 1) / kBlockSize;
+    const Block* block = std::upper_bound(
+            blocks_begin, blocks_end, time,
+            [](float t, const Block& b){return t < b.time_begin;});
+    size_t block_index = block == blocks_begin
+                         ? 0 : (size_t)(block - blocks_begin) - 1;
+    size_t first = block_index * kBlockSize;
+    size_t count = std::min(kBlockSize, size_ - first);
+    size_t low = 0;
+    size_t high = count;
+    while(low < high){
+        size_t middle = (low + high) / 2;
+        if(time < key_time(first + middle))
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    size_t index = first + low;
+    cursor_ = index == 0 ? 0 : std::min(index - 1, last_segment);
+    return cursor_;
+}
+
+CompressionError CompressedKeyframeTrack::MeasureError(
+        const KeyframeTrack& track) const{
+    CompressionError error;
+    error.time = 0.0f;
+    error.position = 0.0f;
+    error.angle_degrees = 0.0f;
+    size_t count = std::min(size_, track.size());
+    for(size_t i = 0; i < count; i++){
+        const Keyframe& source = track.keys()[i];
+        Keyframe decoded = key(i);
+        error.time = std::max(error.time,
+                              std::abs(decoded.time - source.time));
+        error.position = std::max(error.position, glm::length(
+                decoded.position - source.position));
+        error.angle_degrees = std::max(error.angle_degrees, AngleDegrees(
+                decoded.rotation, glm::normalize(source.rotation)));
+    }
+    return error;
+}
@@ -0,0 +1,47 @@
+#include "movement_interpolation/core/fixed_step_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Counted per Advance at most, keeps the cast to the counter defined.
+const double kMaxDropped = 1e18;
+}
+
+FixedStepScheduler::FixedStepScheduler(double step, int max_substeps) :
+        step_(step),
+        max_substeps_(max_substeps),
+        last_time_(0.0),
+        accumulator_(0.0),
+        steps_taken_(0),
+        steps_dropped_(0){}
+
+FixedStepScheduler::~FixedStepScheduler(){}
+
+void FixedStepScheduler::Reset(double now){
+    last_time_ = now;
+    accumulator_ = 0.0;
+}
+
+int FixedStepScheduler::Advance(double now){
+    double elapsed = now - last_time_;
+    last_time_ = now;
+    if(elapsed > 0.0)
+        accumulator_ += elapsed;
+
+    double whole_steps = std::floor(accumulator_ / step_);
+    accumulator_ -= whole_steps * step_;
+    if(accumulator_ < 0.0)
+        accumulator_ = 0.0;
+
+    // Clamped before the cast, a long clock jump exceeds the int range.
+    int steps = max_substeps_;
+    if(whole_steps > max_substeps_){
+        double dropped = std::min(whole_steps - max_substeps_, kMaxDropped);
+        steps_dropped_ += (unsigned long long)dropped;
+    }
+    else
+        steps = (int)whole_steps;
+    steps_taken_ += steps;
+    return steps;
+}
@@ -0,0 +1,297 @@
+#include "movement_interpolation/core/frame_sampler.h"
+#include "movement_interpolation/core/thread_pool.h"
+#include "movement_interpolation/core/trace.h"
+#include "movement_interpolation/core/rotation_stepper.h"
+#include "movement_interpolation/core/interpolation_policy.h"
+#include "movement_interpolation/core/interpolator.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace {
+const size_t kFramesPerTask = 2048;
+// Incremental sampling restarts from an exact SLERP this often, which
+// keeps the accumulated rounding drift below 1e-4 rad.
+const size_t kIncrementalAnchorInterval = 256;
+// Segments shorter than this are not split further.
+const float kAdaptiveMinSegment = 1.0f / (1 << 20);
+
+// Exact sampling loop, instantiated per interpolation method.
+struct SampleRangeVisitor {
+    SampleRangeVisitor(int count, size_t begin, size_t end,
+                       FrameSamples& samples) :
+            count(count), begin(begin), end(end), samples(samples){}
+
+    template<class Kernel>
+    void operator()(const Kernel& kernel) const {
+        for(size_t i = begin; i < end; i++){
+            float t = (float) i / (float) count;
+            samples.positions[i] = kernel.Position(t);
+            samples.euler_angles[i] = kernel.EulerAngles(t);
+            samples.quaternions[i] = kernel.Quaternion(t);
+        }
+    }
+
+    int count;
+    size_t begin;
+    size_t end;
+    FrameSamples& samples;
+};
+
+struct AdaptiveSegment {
+    float begin;
+    float end;
+    // Largest deviation relative to the tolerance, above 1 needs a split.
+    float error;
+
+    bool operator<(const AdaptiveSegment& other) const {
+        return error < other.error;
+    }
+};
+
+// Probes the quarter points, the middle alone misses symmetric bends.
+float SegmentError(const Interpolator& interpolator, float begin, float end,
+                   const AdaptiveTolerance& tolerance){
+    glm::vec3 position_begin = interpolator.InterpolatePosition(begin);
+    glm::vec3 position_end = interpolator.InterpolatePosition(end);
+    glm::quat euler_begin = glm::quat(glm::radians(
+            interpolator.InterpolateEulerAngles(begin)));
+    glm::quat euler_end = glm::quat(glm::radians(
+            interpolator.InterpolateEulerAngles(end)));
+    glm::quat quaternion_begin = interpolator.InterpolateQuaternion(begin);
+    glm::quat quaternion_end = interpolator.InterpolateQuaternion(end);
+
+    float error = 0.0f;
+    for(int i = 1; i < 4; i++){
+        float s = i * 0.25f;
+        float t = begin + (end - begin) * s;
+
+        float position_error = glm::length(
+                interpolator.InterpolatePosition(t)
+                - (position_begin + (position_end - position_begin) * s));
+        float euler_error = AngleDegrees(
+                glm::quat(glm::radians(interpolator.InterpolateEulerAngles(t))),
+                glm::slerp(euler_begin, euler_end, s));
+        float quaternion_error = AngleDegrees(
+                interpolator.InterpolateQuaternion(t),
+                glm::slerp(quaternion_begin, quaternion_end, s));
+
+        error = std::max(error, position_error / tolerance.position);
+        error = std::max(error, std::max(euler_error, quaternion_error)
+                                / tolerance.angle_degrees);
+    }
+    return error;
+}
+
+}
+
+struct FrameSampler::Job {
+    Interpolator interpolator;
+    int count;
+    FrameSamplingMode mode;
+    AdaptiveTolerance tolerance;
+    FrameSamples samples;
+
+    std::atomic<size_t> frames_done;
+    std::atomic<size_t> tasks_left;
+    std::atomic<bool> cancelled;
+};
+
+void FrameSamples::Resize(size_t count){
+    positions.resize(count);
+    euler_angles.resize(count);
+    quaternions.resize(count);
+}
+
+FrameSampler::FrameSampler(std::shared_ptr<ThreadPool> thread_pool) :
+        thread_pool_(thread_pool){}
+
+FrameSampler::~FrameSampler(){
+    Cancel();
+}
+
+void FrameSampler::Start(const Interpolator& interpolator, int count,
+                         FrameSamplingMode mode,
+                         const AdaptiveTolerance& tolerance){
+    Cancel();
+    if(count < 0)
+        count = 0;
+
+    job_ = std::make_shared<Job>();
+    job_->interpolator = interpolator;
+    job_->count = count;
+    job_->mode = mode;
+    job_->tolerance = tolerance;
+    job_->samples = std::move(spare_samples_);
+    job_->frames_done = 0;
+    job_->cancelled = false;
+
+    if(mode == FrameSamplingMode::ADAPTIVE){
+        // Each refinement depends on the previous ones, one task.
+        job_->tasks_left = 1;
+        std::shared_ptr<Job> job = job_;
+        thread_pool_->Submit([job](){
+            TRACE_SCOPE("FrameSampler::SampleAdaptive");
+            SampleAdaptive(job->interpolator, job->count, job->tolerance,
+                           job->samples, &job->cancelled);
+            job->frames_done = job->count;
+            job->tasks_left--;
+        });
+        return;
+    }
+    job_->samples.Resize(count);
+
+    size_t tasks = (count + kFramesPerTask - 1) / kFramesPerTask;
+    job_->tasks_left = tasks;
+    for(size_t task = 0; task < tasks; task++){
+        size_t begin = task * kFramesPerTask;
+        size_t end = std::min((size_t)count, begin + kFramesPerTask);
+        // Tasks own the job, it outlives a cancel or this sampler.
+        std::shared_ptr<Job> job = job_;
+        thread_pool_->Submit([job, begin, end](){
+            TRACE_SCOPE("FrameSampler::SampleRange");
+            if(!job->cancelled){
+                SampleRange(job->interpolator, job->count, job->mode,
+                            begin, end, job->samples);
+                job->frames_done += end - begin;
+            }
+            job->tasks_left--;
+        });
+    }
+}
+
+void FrameSampler::Cancel(){
+    if(job_)
+        job_->cancelled = true;
+    job_.reset();
+}
+
+bool FrameSampler::IsRunning() const{
+    return job_ && job_->tasks_left > 0;
+}
+
+bool FrameSampler::IsDone() const{
+    return job_ && job_->tasks_left == 0;
+}
+
+float FrameSampler::progress() const{
+    if(!job_)
+        return 0.0f;
+    if(job_->count == 0)
+        return 1.0f;
+    return (float)job_->frames_done / (float)job_->count;
+}
+
+bool FrameSampler::TakeSamples(FrameSamples& samples){
+    if(!IsDone())
+        return false;
+    samples = std::move(job_->samples);
+    job_.reset();
+    return true;
+}
+
+void FrameSampler::Recycle(FrameSamples&& samples){
+    spare_samples_ = std::move(samples);
+}
+
+void FrameSampler::Sample(const Interpolator& interpolator, int count,
+                          FrameSamples& samples, ThreadPool* thread_pool,
+                          FrameSamplingMode mode,
+                          const AdaptiveTolerance& tolerance){
+    if(count < 0)
+        count = 0;
+    if(mode == FrameSamplingMode::ADAPTIVE){
+        SampleAdaptive(interpolator, count, tolerance, samples);
+        return;
+    }
+    samples.Resize(count);
+    if(!thread_pool){
+        SampleRange(interpolator, count, mode, 0, count, samples);
+        return;
+    }
+    thread_pool->ParallelFor(count, kFramesPerTask,
+                             [&](size_t begin, size_t end){
+        SampleRange(interpolator, count, mode, begin, end, samples);
+    });
+}
+
+void FrameSampler::SampleAdaptive(const Interpolator& interpolator,
+                                  int max_count,
+                                  const AdaptiveTolerance& tolerance,
+                                  FrameSamples& samples,
+                                  const std::atomic<bool>* cancelled){
+    if(max_count < 2){
+        samples.Resize(max_count > 0 ? 1 : 0);
+        SampleRange(interpolator, 1, FrameSamplingMode::EXACT, 0,
+                    samples.size(), samples);
+        return;
+    }
+    std::priority_queue<AdaptiveSegment> refine;
+
+    AdaptiveSegment whole = {0.0f, 1.0f,
+                             SegmentError(interpolator, 0.0f, 1.0f, tolerance)};
+    refine.push(whole);
+    std::vector<float> times;
+    times.reserve(max_count);
+    times.push_back(0.0f);
+    times.push_back(1.0f);
+
+    while(!refine.empty() && refine.top().error > 1.0f &&
+          (int)times.size() < max_count){
+        if(cancelled && *cancelled)
+            return;
+        AdaptiveSegment segment = refine.top();
+        refine.pop();
+        if(segment.end - segment.begin < kAdaptiveMinSegment)
+            continue;
+
+        float middle = 0.5f * (segment.begin + segment.end);
+        times.push_back(middle);
+        AdaptiveSegment left = {segment.begin, middle,
+                                SegmentError(interpolator, segment.begin,
+                                             middle, tolerance)};
+        AdaptiveSegment right = {middle, segment.end,
+                                 SegmentError(interpolator, middle,
+                                              segment.end, tolerance)};
+        refine.push(left);
+        refine.push(right);
+    }
+    std::sort(times.begin(), times.end());
+
+    samples.Resize(times.size());
+    for(size_t i = 0; i < times.size(); i++){
+        samples.positions[i] = interpolator.InterpolatePosition(times[i]);
+        samples.euler_angles[i]
+                = interpolator.InterpolateEulerAngles(times[i]);
+        samples.quaternions[i] = interpolator.InterpolateQuaternion(times[i]);
+    }
+}
+
+void FrameSampler::SampleRange(const Interpolator& interpolator, int count,
+                               FrameSamplingMode mode,
+                               size_t begin, size_t end,
+                               FrameSamples& samples){
+    if(mode == FrameSamplingMode::INCREMENTAL && begin < end &&
+       interpolator.data().interpolation_method == InterpolationMethod::SLERP){
+        glm::quat delta = interpolator.SlerpDelta(count);
+        for(size_t anchor = begin; anchor < end;
+            anchor += kIncrementalAnchorInterval){
+            size_t anchor_end = std::min(end,
+                                         anchor + kIncrementalAnchorInterval);
+            RotationStepper stepper(
+                    interpolator.InterpolateQuaternion((float)anchor / count),
+                    delta);
+            for(size_t i = anchor; i < anchor_end; i++){
+                float t = (float) i / (float) count;
+                samples.positions[i] = interpolator.InterpolatePosition(t);
+                samples.euler_angles[i]
+                        = interpolator.InterpolateEulerAngles(t);
+                samples.quaternions[i] = stepper.current();
+                stepper.Step();
+            }
+        }
+        return;
+    }
+    DispatchInterpolation(interpolator,
+                          SampleRangeVisitor(count, begin, end, samples));
+}
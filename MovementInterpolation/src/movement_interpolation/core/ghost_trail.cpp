@@ -0,0 +1,61 @@
+#include "movement_interpolation/core/ghost_trail.h"
+#include "movement_interpolation/core/frame_sampler.h"
+#include "movement_interpolation/core/skeleton.h"
+
+GhostTrail::GhostTrail() :
+        euler_count_(0),
+        revision_(0){}
+
+GhostTrail::~GhostTrail(){}
+
+void GhostTrail::Build(const FrameSamples& samples){
+    size_t count = samples.size();
+    instances_.clear();
+    instances_.reserve(2 * count);
+
+    for(size_t i = 0; i < count; i++){
+        // Same conversion the GUI uses between the two representations.
+        glm::quat rotation = glm::normalize(
+                glm::quat(glm::radians(samples.euler_angles[i])));
+        Add(samples.positions[i], rotation);
+    }
+    euler_count_ = count;
+    for(size_t i = 0; i < count; i++)
+        Add(samples.positions[i], samples.quaternions[i]);
+
+    revision_++;
+}
+
+void GhostTrail::Build(const SkeletonPose& pose){
+    instances_.clear();
+    instances_.reserve(pose.size());
+    for(size_t i = 0; i < pose.size(); i++)
+        Add(pose.positions[i], pose.rotations[i]);
+    euler_count_ = 0;
+    revision_++;
+}
+
+void GhostTrail::Clear(){
+    instances_.clear();
+    euler_count_ = 0;
+    revision_++;
+}
+
+void GhostTrail::Release(){
+    std::vector<GhostInstance>().swap(instances_);
+    euler_count_ = 0;
+    revision_++;
+}
+
+void GhostTrail::Add(const glm::vec3& position, const glm::quat& rotation){
+    GhostInstance instance;
+    instance.position[0] = position.x;
+    instance.position[1] = position.y;
+    instance.position[2] = position.z;
+    instance.position[3] = 1.0f;
+    instance.rotation[0] = rotation.x;
+    instance.rotation[1] = rotation.y;
+    instance.rotation[2] = rotation.z;
+    instance.rotation[3] = rotation.w;
+    instances_.push_back(instance);
+}
@@ -0,0 +1,120 @@
+#include "movement_interpolation/core/interpolator.h"
+#include "movement_interpolation/core/interpolation_policy.h"
+
+#include <algorithm>
+#include <cmath>
+
+Interpolator::Interpolator(){
+    data_.position_begin = glm::vec3(0,0,0);
+    data_.position_end = glm::vec3(0,0,0);
+    data_.euler_begin = glm::vec3(0,0,0);
+    data_.euler_end = glm::vec3(0,0,0);
+    data_.quaternion_begin = glm::quat(1,0,0,0);
+    data_.quaternion_end = glm::quat(1,0,0,0);
+    data_.interpolation_method = InterpolationMethod::SLERP;
+    UpdateSlerpConstants();
+}
+
+Interpolator::Interpolator(const InterpolationData& data) :
+        data_(data){
+    UpdateSlerpConstants();
+}
+
+Interpolator::~Interpolator(){}
+
+void Interpolator::data(const InterpolationData& data){
+    data_ = data;
+    UpdateSlerpConstants();
+}
+
+glm::vec3 Interpolator::InterpolatePosition(float t) const{
+    if(data_.position_path)
+        return PathPositionPolicy::Position(data_, t);
+    return LinearPositionPolicy::Position(data_, t);
+}
+
+glm::vec3 Interpolator::InterpolateEulerAngles(float t) const{
+    return LinearPositionPolicy::EulerAngles(data_, t);
+}
+
+glm::quat Interpolator::InterpolateQuaternion(float t) const{
+    switch(data_.interpolation_method){
+        case InterpolationMethod::LERP:
+            return LerpPolicy::Quaternion(quaternion_constants_, t);
+        case InterpolationMethod::SLERP:
+            return SlerpPolicy::Quaternion(quaternion_constants_, t);
+        case InterpolationMethod::FAST_SLERP:
+            return FastSlerpPolicy::Quaternion(quaternion_constants_, t);
+    }
+    return quaternion_constants_.begin;
+}
+
+Pose Interpolator::InterpolatePose(float t) const{
+    Pose pose;
+    pose.position = InterpolatePosition(t);
+    pose.rotation = InterpolateQuaternion(t);
+    return pose;
+}
+
+glm::vec3 Interpolator::InterpolateQuaternions(float t) const{
+    return QuaternionToEulerDegrees(InterpolateQuaternion(t));
+}
+
+glm::quat Interpolator::SlerpDelta(int steps) const{
+    const QuaternionConstants& c = quaternion_constants_;
+    if(c.linear || steps <= 0)
+        return glm::quat(1,0,0,0);
+    // relative = begin^-1 * end, its angle is 2 * theta.
+    glm::quat relative = glm::conjugate(c.begin) * c.shortest_end;
+    glm::vec3 axis(relative.x, relative.y, relative.z);
+    float axis_length = glm::length(axis);
+    if(axis_length <= 0.0f)
+        return glm::quat(1,0,0,0);
+    float half_angle = c.theta / (float)steps;
+    return glm::quat(std::cos(half_angle),
+                     axis * (std::sin(half_angle) / axis_length));
+}
+
+void Interpolator::UpdateSlerpConstants(){
+    quaternion_constants_ = ComputeQuaternionConstants(
+            data_.quaternion_begin, data_.quaternion_end);
+}
+
+QuaternionConstants ComputeQuaternionConstants(const glm::quat& begin,
+                                               const glm::quat& end){
+    QuaternionConstants c;
+    c.begin = begin;
+    c.end = end;
+    c.shortest_end = end;
+    float cos_theta = glm::dot(c.begin, c.shortest_end);
+    if(cos_theta < 0.0f){
+        c.shortest_end = -c.shortest_end;
+        cos_theta = -cos_theta;
+    }
+    // Same threshold as glm::slerp.
+    c.linear = cos_theta > 1.0f - glm::epsilon<float>();
+    c.theta = 0.0f;
+    c.inv_sin_theta = 0.0f;
+    if(!c.linear){
+        c.theta = std::acos(cos_theta);
+        c.inv_sin_theta = 1.0f / std::sin(c.theta);
+    }
+    FastSlerpCoefficients(cos_theta, c.fast_slerp_a, c.fast_slerp_b);
+    return c;
+}
+
+// Fitted by Arseny Kapoulkine, "Approximating slerp" (2015).
+void FastSlerpCoefficients(float cos_theta, float& a, float& b){
+    float d = cos_theta;
+    a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+    b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+}
+
+glm::vec3 QuaternionToEulerDegrees(const glm::quat& q){
+    return glm::degrees(glm::eulerAngles(q));
+}
+
+float AngleDegrees(const glm::quat& a, const glm::quat& b){
+    float cos_half = std::min(std::abs(glm::dot(a, b)), 1.0f);
+    return glm::degrees(2.0f * std::acos(cos_half));
+}
@@ -0,0 +1,297 @@
+#include "movement_interpolation/core/keyframe_file.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[4] = {'M', 'I', 'K', 'F'};
+const size_t kHeaderSize = 16;
+const size_t kNameSize = 32;
+const size_t kKeyAlignment = 16;
+
+static_assert(sizeof(Keyframe) == 32,
+              "Keyframe must match the keyframe file key layout");
+
+struct Header {
+    char magic[4];
+    uint16_t version;
+    uint16_t key_size;
+    uint32_t track_count;
+    uint32_t reserved;
+};
+static_assert(sizeof(Header) == kHeaderSize, "Unexpected header padding");
+
+// Keys are used in place, which needs a little-endian host with glm
+// storing quaternions as x, y, z, w.
+bool HostMatchesFileLayout(){
+    uint16_t probe = 1;
+    unsigned char first_byte;
+    std::memcpy(&first_byte, &probe, 1);
+
+    glm::quat q(4.0f, 1.0f, 2.0f, 3.0f);
+    float raw[4];
+    std::memcpy(raw, &q, sizeof(raw));
+    return first_byte == 1 && raw[0] == 1.0f && raw[3] == 4.0f;
+}
+
+size_t Align(size_t offset){
+    return (offset + kKeyAlignment - 1) / kKeyAlignment * kKeyAlignment;
+}
+
+}
+
+struct KeyframeFile::TrackEntry {
+    char name[kNameSize];
+    uint64_t keys_offset;
+    uint32_t key_count;
+    uint32_t interpolation_method;
+    int32_t parent;
+    uint32_t reserved;
+};
+
+struct KeyframeFile::Mapping {
+    const unsigned char* data;
+    size_t size;
+    // Per track, whether Track checked the order of all keys yet.
+    std::vector<TrackState> track_states;
+
+    Mapping() : data(nullptr), size(0){}
+    ~Mapping(){
+        if(data)
+            munmap((void*)data, size);
+    }
+};
+
+KeyframeFile::KeyframeFile(){}
+
+KeyframeFile::~KeyframeFile(){}
+
+bool KeyframeFile::Open(const std::string& path){
+    static_assert(sizeof(TrackEntry) == 56, "Unexpected track entry padding");
+    Close();
+    if(!HostMatchesFileLayout()){
+        error_ = "Keyframe files are not supported on this platform";
+        return false;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        error_ = "Could not open " + path;
+        return false;
+    }
+    struct stat status;
+    if(fstat(fd, &status) != 0 || status.st_size < (off_t)kHeaderSize){
+        close(fd);
+        error_ = path + " is not a keyframe file";
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after closing the descriptor.
+    close(fd);
+    if(data == MAP_FAILED){
+        error_ = "Could not map " + path;
+        return false;
+    }
+
+    mapping_ = std::make_shared<Mapping>();
+    mapping_->data = (const unsigned char*)data;
+    mapping_->size = (size_t)status.st_size;
+    if(!Validate()){
+        error_ = path + ": " + error_;
+        mapping_.reset();
+        return false;
+    }
+    error_.clear();
+    return true;
+}
+
+void KeyframeFile::Close(){
+    mapping_.reset();
+}
+
+size_t KeyframeFile::track_count() const{
+    if(!mapping_)
+        return 0;
+    return ((const Header*)mapping_->data)->track_count;
+}
+
+std::string KeyframeFile::track_name(size_t index) const{
+    const TrackEntry* entry = Entry(index);
+    if(!entry)
+        return std::string();
+    size_t length = 0;
+    while(length < kNameSize && entry->name[length] != '\0')
+        length++;
+    return std::string(entry->name, length);
+}
+
+int KeyframeFile::track_parent(size_t index) const{
+    const TrackEntry* entry = Entry(index);
+    return entry ? entry->parent : -1;
+}
+
+size_t KeyframeFile::FindTrack(const std::string& name) const{
+    for(size_t i = 0; i < track_count(); i++){
+        if(track_name(i) == name)
+            return i;
+    }
+    return track_count();
+}
+
+std::shared_ptr<KeyframeTrack> KeyframeFile::Track(size_t index) const{
+    const TrackEntry* entry = Entry(index);
+    if(!entry){
+        error_ = "track " + std::to_string(index) + " does not exist";
+        return nullptr;
+    }
+    // Checked here rather than in Open, which would read the whole file.
+    TrackState& state = mapping_->track_states[index];
+    if(state == TrackState::UNCHECKED){
+        state = KeysSorted(*entry) ? TrackState::SORTED
+                                   : TrackState::UNSORTED;
+    }
+    if(state == TrackState::UNSORTED){
+        error_ = "track " + std::to_string(index)
+                 + " has keys out of time order";
+        return nullptr;
+    }
+
+    std::shared_ptr<Mapping> mapping = mapping_;
+    std::shared_ptr<KeyframeTrack> track(
+            new KeyframeTrack(),
+            [mapping](KeyframeTrack* track){delete track;});
+    track->interpolation_method(
+            (KeyframeInterpolationMethod)entry->interpolation_method);
+    track->View((const Keyframe*)(mapping_->data + entry->keys_offset),
+                entry->key_count);
+    return track;
+}
+
+bool KeyframeFile::Write(const std::string& path,
+                         const std::vector<NamedKeyframeTrack>& tracks){
+    if(!HostMatchesFileLayout())
+        return false;
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if(!file)
+        return false;
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kKeyframeFileVersion;
+    header.key_size = sizeof(Keyframe);
+    header.track_count = (uint32_t)tracks.size();
+    header.reserved = 0;
+    bool success = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    size_t offset = Align(kHeaderSize + tracks.size() * sizeof(TrackEntry));
+    for(const NamedKeyframeTrack& named_track : tracks){
+        TrackEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        std::strncpy(entry.name, named_track.name.c_str(), kNameSize - 1);
+        entry.keys_offset = offset;
+        entry.key_count = (uint32_t)named_track.track->size();
+        entry.interpolation_method
+                = (uint32_t)named_track.track->interpolation_method();
+        entry.parent = named_track.parent;
+        success = success && std::fwrite(&entry, sizeof(entry), 1, file) == 1;
+        offset = Align(offset + entry.key_count * sizeof(Keyframe));
+    }
+
+    const unsigned char padding[kKeyAlignment] = {0};
+    size_t position = kHeaderSize + tracks.size() * sizeof(TrackEntry);
+    for(const NamedKeyframeTrack& named_track : tracks){
+        size_t aligned = Align(position);
+        success = success && std::fwrite(padding, 1, aligned - position,
+                                         file) == aligned - position;
+        size_t count = named_track.track->size();
+        success = success && std::fwrite(named_track.track->keys(),
+                                         sizeof(Keyframe), count,
+                                         file) == count;
+        position = aligned + count * sizeof(Keyframe);
+    }
+    return std::fclose(file) == 0 && success;
+}
+
+const KeyframeFile::TrackEntry* KeyframeFile::Entry(size_t index) const{
+    if(index >= track_count())
+        return nullptr;
+    return (const TrackEntry*)(mapping_->data + kHeaderSize) + index;
+}
+
+bool KeyframeFile::Validate(){
+    const Header* header = (const Header*)mapping_->data;
+    if(std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0){
+        error_ = "not a keyframe file";
+        return false;
+    }
+    if(header->version != kKeyframeFileVersion ||
+       header->key_size != sizeof(Keyframe)){
+        error_ = "unsupported keyframe file version";
+        return false;
+    }
+    uint64_t table_end = kHeaderSize
+                         + (uint64_t)header->track_count * sizeof(TrackEntry);
+    if(table_end > mapping_->size){
+        error_ = "truncated track table";
+        return false;
+    }
+    for(size_t i = 0; i < header->track_count; i++){
+        const TrackEntry* entry = Entry(i);
+        // Compared without computing the end, which could wrap around.
+        if(entry->keys_offset % alignof(Keyframe) != 0 ||
+           entry->keys_offset < table_end ||
+           entry->keys_offset > mapping_->size ||
+           entry->key_count > (mapping_->size - entry->keys_offset)
+                              / sizeof(Keyframe)){
+            error_ = "track " + std::to_string(i) + " is out of bounds";
+            return false;
+        }
+        // Only the ends, Track checks the keys in between.
+        const Keyframe* keys
+                = (const Keyframe*)(mapping_->data + entry->keys_offset);
+        if(entry->key_count > 0 &&
+           (!std::isfinite(keys[0].time) ||
+            !std::isfinite(keys[entry->key_count - 1].time) ||
+            keys[entry->key_count - 1].time < keys[0].time)){
+            error_ = "track " + std::to_string(i)
+                     + " has keys out of time order";
+            return false;
+        }
+        if(entry->parent < -1 ||
+           entry->parent >= (int64_t)header->track_count ||
+           entry->parent == (int64_t)i){
+            error_ = "track " + std::to_string(i)
+                     + " has an invalid parent";
+            return false;
+        }
+        if(entry->interpolation_method
+           > (uint32_t)KeyframeInterpolationMethod::SQUAD){
+            error_ = "track " + std::to_string(i)
+                     + " has an unknown interpolation method";
+            return false;
+        }
+    }
+    mapping_->track_states.assign(header->track_count,
+                                  TrackState::UNCHECKED);
+    return true;
+}
+
+bool KeyframeFile::KeysSorted(const TrackEntry& entry) const{
+    // KeyframeTrack searches the keys, they must be sorted by time.
+    const Keyframe* keys
+            = (const Keyframe*)(mapping_->data + entry.keys_offset);
+    for(size_t k = 0; k < entry.key_count; k++){
+        if(!std::isfinite(keys[k].time) ||
+           (k > 0 && keys[k].time < keys[k - 1].time))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+#include "movement_interpolation/core/keyframe_reduction.h"
+#include "movement_interpolation/core/thread_pool.h"
+#include "movement_interpolation/core/interpolator.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+/**
+ * Reconstruction of key k from the keys begin and end, the same formulas
+ * KeyframeTrack::Evaluate uses.
+ */
+void Reconstruct(const Keyframe& begin, const Keyframe& end,
+                 const Keyframe& key, bool lerp,
+                 glm::vec3& position, glm::quat& rotation){
+    float length = end.time - begin.time;
+    float t = length <= 0.0f ? 0.0f
+              : glm::clamp((key.time - begin.time) / length, 0.0f, 1.0f);
+    position = begin.position + (end.position - begin.position) * t;
+    rotation = lerp ? glm::lerp(begin.rotation, end.rotation, t)
+                    : glm::slerp(begin.rotation, end.rotation, t);
+    rotation = glm::normalize(rotation);
+}
+
+}
+
+ReductionStats ReduceKeyframes(const KeyframeTrack& track,
+                               const ReductionTolerance& tolerance,
+                               KeyframeTrack& reduced){
+    ReductionStats stats;
+    stats.source_keys = track.size();
+    stats.position_error = 0.0f;
+    stats.angle_error_degrees = 0.0f;
+
+    bool lerp = track.interpolation_method()
+                == KeyframeInterpolationMethod::LERP;
+    reduced.Clear();
+    reduced.interpolation_method(lerp ? KeyframeInterpolationMethod::LERP
+                                      : KeyframeInterpolationMethod::SLERP);
+
+    const Keyframe* keys = track.keys();
+    size_t count = track.size();
+    if(count <= 2){
+        for(size_t i = 0; i < count; i++)
+            reduced.AddKey(keys[i]);
+        stats.reduced_keys = count;
+        return stats;
+    }
+
+    float inv_position = tolerance.position > 0.0f
+                         ? 1.0f / tolerance.position : 0.0f;
+    float inv_angle = tolerance.angle_degrees > 0.0f
+                      ? 1.0f / tolerance.angle_degrees : 0.0f;
+
+    std::vector<char> keep(count, 0);
+    keep[0] = 1;
+    keep[count - 1] = 1;
+    std::vector<std::pair<size_t, size_t>> segments;
+    segments.push_back(std::make_pair((size_t)0, count - 1));
+    while(!segments.empty()){
+        size_t begin = segments.back().first;
+        size_t end = segments.back().second;
+        segments.pop_back();
+
+        // Worst key by error relative to the tolerance, a zero tolerance
+        // keeps every key that differs at all.
+        size_t worst = begin;
+        float worst_error = 0.0f;
+        float position_error = 0.0f;
+        float angle_error = 0.0f;
+        for(size_t k = begin + 1; k < end; k++){
+            glm::vec3 position;
+            glm::quat rotation;
+            Reconstruct(keys[begin], keys[end], keys[k], lerp,
+                        position, rotation);
+            float distance = glm::length(position - keys[k].position);
+            float angle = AngleDegrees(rotation,
+                                       glm::normalize(keys[k].rotation));
+            float error = std::max(
+                    inv_position > 0.0f ? distance * inv_position
+                                        : (distance > 0.0f ? 2.0f : 0.0f),
+                    inv_angle > 0.0f ? angle * inv_angle
+                                     : (angle > 0.0f ? 2.0f : 0.0f));
+            if(error > worst_error){
+                worst = k;
+                worst_error = error;
+            }
+            position_error = std::max(position_error, distance);
+            angle_error = std::max(angle_error, angle);
+        }
+        if(worst_error > 1.0f){
+            keep[worst] = 1;
+            segments.push_back(std::make_pair(begin, worst));
+            segments.push_back(std::make_pair(worst, end));
+            continue;
+        }
+        stats.position_error = std::max(stats.position_error, position_error);
+        stats.angle_error_degrees = std::max(stats.angle_error_degrees,
+                                             angle_error);
+    }
+
+    size_t kept = (size_t)std::count(keep.begin(), keep.end(), 1);
+    reduced.Reserve(kept);
+    for(size_t i = 0; i < count; i++){
+        if(keep[i])
+            reduced.AddKey(keys[i]);
+    }
+    stats.reduced_keys = kept;
+    return stats;
+}
+
+ReductionStats ReduceKeyframes(const std::vector<NamedKeyframeTrack>& tracks,
+                               const ReductionTolerance& tolerance,
+                               std::vector<NamedKeyframeTrack>& reduced,
+                               ThreadPool* thread_pool){
+    reduced.resize(tracks.size());
+    std::vector<ReductionStats> track_stats(tracks.size());
+    auto reduce = [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            reduced[i].name = tracks[i].name;
+            reduced[i].parent = tracks[i].parent;
+            reduced[i].track = std::make_shared<KeyframeTrack>();
+            track_stats[i] = ReduceKeyframes(*tracks[i].track, tolerance,
+                                             *reduced[i].track);
+        }
+    };
+    // One track per task, tracks differ a lot in how many keys they keep.
+    if(thread_pool)
+        thread_pool->ParallelFor(tracks.size(), 1, reduce);
+    else
+        reduce(0, tracks.size());
+
+    ReductionStats stats = ReductionStats();
+    for(const ReductionStats& track : track_stats){
+        stats.source_keys += track.source_keys;
+        stats.reduced_keys += track.reduced_keys;
+        stats.position_error = std::max(stats.position_error,
+                                        track.position_error);
+        stats.angle_error_degrees = std::max(stats.angle_error_degrees,
+                                             track.angle_error_degrees);
+    }
+    return stats;
+}
@@ -0,0 +1,206 @@
+#include "movement_interpolation/core/keyframe_track.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+glm::quat Log(const glm::quat& q){
+    glm::vec3 v(q.x, q.y, q.z);
+    float sin_theta = glm::length(v);
+    if(sin_theta < 1e-6f)
+        return glm::quat(0.0f, v);
+    float theta = std::atan2(sin_theta, q.w);
+    return glm::quat(0.0f, v * (theta / sin_theta));
+}
+
+glm::quat Exp(const glm::quat& q){
+    glm::vec3 v(q.x, q.y, q.z);
+    float theta = glm::length(v);
+    if(theta < 1e-6f)
+        return glm::normalize(glm::quat(1.0f, v));
+    return glm::quat(std::cos(theta), v * (std::sin(theta) / theta));
+}
+
+glm::quat Hemisphere(const glm::quat& q, const glm::quat& reference){
+    return glm::dot(q, reference) < 0.0f ? -q : q;
+}
+
+// Shoemake's inner quadrangle point of q between prev and next.
+glm::quat Intermediate(const glm::quat& prev, const glm::quat& q,
+                       const glm::quat& next){
+    glm::quat q_inv = glm::conjugate(q);
+    glm::quat sum = Log(q_inv * Hemisphere(next, q))
+                    + Log(q_inv * Hemisphere(prev, q));
+    return glm::normalize(q * Exp(sum * -0.25f));
+}
+
+}
+
+KeyframeTrack::KeyframeTrack() :
+        keys_(nullptr),
+        size_(0),
+        is_view_(false),
+        interpolation_method_(KeyframeInterpolationMethod::SLERP),
+        cursor_(0),
+        squad_control_points_dirty_(true){}
+
+KeyframeTrack::~KeyframeTrack(){}
+
+float KeyframeTrack::start_time() const{
+    return size_ == 0 ? 0.0f : keys_[0].time;
+}
+
+float KeyframeTrack::end_time() const{
+    return size_ == 0 ? 0.0f : keys_[size_ - 1].time;
+}
+
+void KeyframeTrack::AddKey(const Keyframe& key){
+    if(is_view_)
+        owned_keys_.assign(keys_, keys_ + size_);
+    if(owned_keys_.empty() || owned_keys_.back().time <= key.time){
+        owned_keys_.push_back(key);
+    }else{
+        auto position = std::upper_bound(
+                owned_keys_.begin(), owned_keys_.end(), key.time,
+                [](float time, const Keyframe& k){return time < k.time;});
+        owned_keys_.insert(position, key);
+    }
+    UseOwnedKeys();
+    squad_control_points_dirty_ = true;
+}
+
+void KeyframeTrack::Reserve(size_t count){
+    owned_keys_.reserve(count);
+    if(!is_view_)
+        UseOwnedKeys();
+}
+
+void KeyframeTrack::Clear(){
+    owned_keys_.clear();
+    UseOwnedKeys();
+    squad_control_points_.clear();
+    squad_control_points_dirty_ = true;
+    cursor_ = 0;
+}
+
+void KeyframeTrack::View(const Keyframe* keys, size_t count){
+    owned_keys_.clear();
+    keys_ = keys;
+    size_ = count;
+    is_view_ = true;
+    squad_control_points_dirty_ = true;
+    cursor_ = 0;
+}
+
+void KeyframeTrack::UseOwnedKeys(){
+    keys_ = owned_keys_.data();
+    size_ = owned_keys_.size();
+    is_view_ = false;
+}
+
+void KeyframeTrack::Evaluate(float time,
+                             glm::vec3& position, glm::quat& rotation) const{
+    if(size_ == 0){
+        position = glm::vec3(0,0,0);
+        rotation = glm::quat(1,0,0,0);
+        return;
+    }
+    if(size_ == 1){
+        position = keys_[0].position;
+        rotation = keys_[0].rotation;
+        return;
+    }
+    size_t segment = FindSegment(time);
+    float t = SegmentT(segment, time);
+
+    const Keyframe& begin = keys_[segment];
+    const Keyframe& end = keys_[segment + 1];
+    position = begin.position + (end.position - begin.position) * t;
+    rotation = InterpolateRotation(segment, t);
+}
+
+glm::vec3 KeyframeTrack::EvaluatePosition(float time) const{
+    glm::vec3 position;
+    glm::quat rotation;
+    Evaluate(time, position, rotation);
+    return position;
+}
+
+glm::quat KeyframeTrack::EvaluateRotation(float time) const{
+    glm::vec3 position;
+    glm::quat rotation;
+    Evaluate(time, position, rotation);
+    return rotation;
+}
+
+size_t KeyframeTrack::FindSegment(float time) const{
+    size_t last_segment = size_ - 2;
+    if(cursor_ > last_segment)
+        cursor_ = last_segment;
+
+    // Same segment or the next one during forward playback.
+    if(keys_[cursor_].time <= time){
+        if(cursor_ == last_segment || time < keys_[cursor_ + 1].time)
+            return cursor_;
+        if(cursor_ + 1 == last_segment || time < keys_[cursor_ + 2].time)
+            return ++cursor_;
+    }
+
+    const Keyframe* upper = std::upper_bound(
+            keys_, keys_ + size_, time,
+            [](float t, const Keyframe& k){return t < k.time;});
+    size_t index = (size_t)(upper - keys_);
+    cursor_ = index == 0 ? 0 : std::min(index - 1, last_segment);
+    return cursor_;
+}
+
+float KeyframeTrack::SegmentT(size_t segment, float time) const{
+    float begin = keys_[segment].time;
+    float length = keys_[segment + 1].time - begin;
+    if(length <= 0.0f)
+        return 0.0f;
+    return glm::clamp((time - begin) / length, 0.0f, 1.0f);
+}
+
+glm::quat KeyframeTrack::InterpolateRotation(size_t segment, float t) const{
+    const glm::quat& q0 = keys_[segment].rotation;
+    const glm::quat& q1 = keys_[segment + 1].rotation;
+
+    glm::quat q;
+    switch(interpolation_method_){
+        case KeyframeInterpolationMethod::LERP:
+            q = glm::lerp(q0, q1, t);
+            break;
+        case KeyframeInterpolationMethod::SLERP:
+            q = glm::slerp(q0, q1, t);
+            break;
+        case KeyframeInterpolationMethod::SQUAD: {
+            UpdateSquadControlPoints();
+            glm::quat q1_near = Hemisphere(q1, q0);
+            glm::quat s0 = squad_control_points_[segment];
+            glm::quat s1 = Hemisphere(squad_control_points_[segment + 1], q0);
+            q = glm::mix(glm::mix(q0, q1_near, t), glm::mix(s0, s1, t),
+                         2.0f * t * (1.0f - t));
+            break;
+        }
+    }
+    return glm::normalize(q);
+}
+
+void KeyframeTrack::UpdateSquadControlPoints() const{
+    if(!squad_control_points_dirty_)
+        return;
+    size_t count = size_;
+    squad_control_points_.resize(count);
+    for(size_t i = 0; i < count; i++){
+        const glm::quat& q = keys_[i].rotation;
+        if(i == 0 || i == count - 1){
+            squad_control_points_[i] = q;
+            continue;
+        }
+        squad_control_points_[i] = Intermediate(keys_[i - 1].rotation, q,
+                                                keys_[i + 1].rotation);
+    }
+    squad_control_points_dirty_ = false;
+}
@@ -0,0 +1,71 @@
+#include "movement_interpolation/core/latency_histogram.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+const double kMinSeconds = 1e-6;
+}
+
+const int LatencyHistogram::kBucketsPerOctave;
+const int LatencyHistogram::kBucketCount;
+const size_t LatencyHistogram::kWindowSize;
+
+LatencyHistogram::LatencyHistogram(){
+    Clear();
+}
+
+void LatencyHistogram::Add(double seconds){
+    if(count_ == kWindowSize)
+        bucket_counts_[window_[next_]]--;
+    else
+        count_++;
+    uint8_t bucket = Bucket(seconds);
+    window_[next_] = bucket;
+    bucket_counts_[bucket]++;
+    next_ = (next_ + 1) % kWindowSize;
+}
+
+void LatencyHistogram::Clear(){
+    std::memset(bucket_counts_, 0, sizeof(bucket_counts_));
+    next_ = 0;
+    count_ = 0;
+}
+
+float LatencyHistogram::Percentile(float fraction) const{
+    if(count_ == 0)
+        return 0.0f;
+    // Rank of the duration, counted from 1.
+    size_t rank = (size_t)std::ceil(fraction * count_);
+    if(rank < 1)
+        rank = 1;
+    size_t seen = 0;
+    for(int bucket = 0; bucket < kBucketCount; bucket++){
+        seen += bucket_counts_[bucket];
+        if(seen >= rank)
+            return BucketUpperBound(bucket);
+    }
+    return BucketUpperBound(kBucketCount - 1);
+}
+
+LatencyPercentiles LatencyHistogram::Percentiles() const{
+    LatencyPercentiles percentiles;
+    percentiles.p50 = Percentile(0.50f);
+    percentiles.p95 = Percentile(0.95f);
+    percentiles.p99 = Percentile(0.99f);
+    return percentiles;
+}
+
+uint8_t LatencyHistogram::Bucket(double seconds){
+    if(!(seconds > kMinSeconds))
+        return 0;
+    int bucket = (int)(std::log2(seconds / kMinSeconds) * kBucketsPerOctave);
+    if(bucket >= kBucketCount)
+        bucket = kBucketCount - 1;
+    return (uint8_t)bucket;
+}
+
+float LatencyHistogram::BucketUpperBound(int bucket){
+    return (float)(kMinSeconds * std::exp2((double)(bucket + 1)
+                                           / kBucketsPerOctave));
+}
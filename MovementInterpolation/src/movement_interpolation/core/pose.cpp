@@ -0,0 +1,24 @@
+#include "movement_interpolation/core/pose.h"
+
+glm::mat4 PoseToModelMatrix(const Pose& pose, float scale){
+    const glm::quat& q = pose.rotation;
+    float xx = q.x * q.x;
+    float yy = q.y * q.y;
+    float zz = q.z * q.z;
+    float xy = q.x * q.y;
+    float xz = q.x * q.z;
+    float yz = q.y * q.z;
+    float wx = q.w * q.x;
+    float wy = q.w * q.y;
+    float wz = q.w * q.z;
+
+    glm::mat4 model(1.0f);
+    model[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz),
+                         2.0f * (xz - wy), 0.0f) * scale;
+    model[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz),
+                         2.0f * (yz + wx), 0.0f) * scale;
+    model[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx),
+                         1.0f - 2.0f * (xx + yy), 0.0f) * scale;
+    model[3] = glm::vec4(pose.position, 1.0f);
+    return model;
+}
@@ -0,0 +1,72 @@
+#include "movement_interpolation/core/pose_blender.h"
+
+#include <algorithm>
+
+namespace {
+
+// Rotations cancelling each other out keep the first weighted rotation.
+const float kMinRotationLength = 1e-6f;
+
+}
+
+PoseBlender::PoseBlender() : object_count_(0){}
+
+PoseBlender::~PoseBlender(){}
+
+void PoseBlender::Resize(size_t input_count, size_t object_count){
+    Pose identity;
+    identity.position = glm::vec3(0, 0, 0);
+    identity.rotation = glm::quat(1, 0, 0, 0);
+
+    object_count_ = object_count;
+    inputs_.assign(input_count * object_count, identity);
+    weights_.resize(input_count, 0.0f);
+}
+
+void PoseBlender::Blend(Pose* output) const {
+    if(input_count() == 0 || object_count_ == 0)
+        return;
+
+    float weight_sum = 0.0f;
+    size_t first = input_count();
+    for(size_t i = 0; i < input_count(); i++){
+        if(weights_[i] <= 0.0f)
+            continue;
+        weight_sum += weights_[i];
+        first = std::min(first, i);
+    }
+    if(first == input_count()){
+        std::copy(input(0), input(0) + object_count_, output);
+        return;
+    }
+
+    // Inputs outer, objects inner: every pass streams one contiguous
+    // block of poses and the accumulators.
+    const Pose* reference = input(first);
+    float first_weight = weights_[first] / weight_sum;
+    for(size_t j = 0; j < object_count_; j++){
+        output[j].position = reference[j].position * first_weight;
+        output[j].rotation = reference[j].rotation * first_weight;
+    }
+    for(size_t i = first + 1; i < input_count(); i++){
+        if(weights_[i] <= 0.0f)
+            continue;
+        const Pose* poses = input(i);
+        float weight = weights_[i] / weight_sum;
+        for(size_t j = 0; j < object_count_; j++){
+            output[j].position += poses[j].position * weight;
+            float sign = glm::dot(reference[j].rotation,
+                                  poses[j].rotation) < 0.0f ? -1.0f : 1.0f;
+            output[j].rotation = output[j].rotation
+                                 + poses[j].rotation * (weight * sign);
+        }
+    }
+
+    for(size_t j = 0; j < object_count_; j++){
+        float length = glm::length(output[j].rotation);
+        if(length < kMinRotationLength)
+            output[j].rotation = reference[j].rotation;
+        else
+            output[j].rotation = output[j].rotation * (1.0f / length);
+    }
+}
@@ -0,0 +1,19 @@
+#include "movement_interpolation/core/rotation_stepper.h"
+
+RotationStepper::RotationStepper(const glm::quat& start,
+                                 const glm::quat& delta,
+                                 int renormalize_interval) :
+        current_(start),
+        delta_(delta),
+        renormalize_interval_(renormalize_interval),
+        steps_since_renormalize_(0){}
+
+RotationStepper::~RotationStepper(){}
+
+void RotationStepper::Step(){
+    current_ = current_ * delta_;
+    if(++steps_since_renormalize_ >= renormalize_interval_){
+        current_ = glm::normalize(current_);
+        steps_since_renormalize_ = 0;
+    }
+}
@@ -0,0 +1,95 @@
+#include "movement_interpolation/core/skeleton.h"
+
+#include <algorithm>
+
+Skeleton::Skeleton(){}
+
+Skeleton::~Skeleton(){}
+
+int Skeleton::AddJoint(const std::string& name, int parent){
+    if(parent < -1 || parent >= (int)size())
+        return -1;
+    parents_.push_back(parent);
+    names_.push_back(name);
+    return (int)size() - 1;
+}
+
+void Skeleton::Clear(){
+    parents_.clear();
+    names_.clear();
+}
+
+void SkeletonPose::Resize(size_t count){
+    positions.resize(count, glm::vec3(0, 0, 0));
+    rotations.resize(count, glm::quat(1, 0, 0, 0));
+}
+
+void LocalToWorld(const Skeleton& skeleton, const SkeletonPose& local,
+                  SkeletonPose& world){
+    size_t count = std::min(skeleton.size(), local.size());
+    world.Resize(count);
+    const int* parents = skeleton.parents().data();
+    for(size_t i = 0; i < count; i++){
+        int parent = parents[i];
+        if(parent < 0){
+            world.positions[i] = local.positions[i];
+            world.rotations[i] = local.rotations[i];
+            continue;
+        }
+        const glm::quat& parent_rotation = world.rotations[parent];
+        world.positions[i] = world.positions[parent]
+                             + parent_rotation * local.positions[i];
+        world.rotations[i] = parent_rotation * local.rotations[i];
+    }
+}
+
+SkeletonTrack::SkeletonTrack() :
+        start_time_(0.0f),
+        end_time_(0.0f){}
+
+SkeletonTrack::~SkeletonTrack(){}
+
+bool SkeletonTrack::Set(
+        std::shared_ptr<const Skeleton> skeleton,
+        const std::vector<std::shared_ptr<KeyframeTrack>>& tracks){
+    skeleton_.reset();
+    tracks_.clear();
+    start_time_ = 0.0f;
+    end_time_ = 0.0f;
+    if(!skeleton || tracks.size() != skeleton->size())
+        return false;
+    for(const std::shared_ptr<KeyframeTrack>& track : tracks){
+        if(!track)
+            return false;
+    }
+
+    skeleton_ = skeleton;
+    tracks_ = tracks;
+    bool first = true;
+    for(const std::shared_ptr<KeyframeTrack>& track : tracks_){
+        if(track->size() == 0)
+            continue;
+        start_time_ = first ? track->start_time()
+                            : std::min(start_time_, track->start_time());
+        end_time_ = first ? track->end_time()
+                          : std::max(end_time_, track->end_time());
+        first = false;
+    }
+    return true;
+}
+
+void SkeletonTrack::EvaluateLocal(float time, SkeletonPose& local) const{
+    local.Resize(tracks_.size());
+    float track_time = start_time_ + time;
+    for(size_t i = 0; i < tracks_.size(); i++){
+        tracks_[i]->Evaluate(track_time, local.positions[i],
+                             local.rotations[i]);
+    }
+}
+
+void SkeletonTrack::Evaluate(float time, SkeletonPose& local,
+                             SkeletonPose& world) const{
+    EvaluateLocal(time, local);
+    if(skeleton_)
+        LocalToWorld(*skeleton_, local, world);
+}
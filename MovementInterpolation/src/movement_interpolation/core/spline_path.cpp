@@ -0,0 +1,127 @@
+#include "movement_interpolation/core/spline_path.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Chord samples per segment. On typical paths the length is within 1e-4
+// of the integrated arc length and constant speed playback within 1%.
+const size_t kLookupSamplesPerSegment = 128;
+
+glm::vec3 CatmullRom(const glm::vec3& p0, const glm::vec3& p1,
+                     const glm::vec3& p2, const glm::vec3& p3, float t){
+    float t2 = t * t;
+    float t3 = t2 * t;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * t
+                   + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2
+                   + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+glm::vec3 Bezier(const glm::vec3& p0, const glm::vec3& p1,
+                 const glm::vec3& p2, const glm::vec3& p3, float t){
+    float s = 1.0f - t;
+    return (s * s * s) * p0 + (3.0f * s * s * t) * p1
+           + (3.0f * s * t * t) * p2 + (t * t * t) * p3;
+}
+
+}
+
+SplinePath::SplinePath(SplineType type) :
+        type_(type),
+        constant_speed_(false),
+        length_(0.0f){}
+
+SplinePath::SplinePath(SplineType type,
+                       const std::vector<glm::vec3>& control_points) :
+        type_(type),
+        control_points_(control_points),
+        constant_speed_(false),
+        length_(0.0f){
+    BuildLookupTable();
+}
+
+SplinePath::~SplinePath(){}
+
+void SplinePath::type(SplineType type){
+    type_ = type;
+    BuildLookupTable();
+}
+
+void SplinePath::control_points(const std::vector<glm::vec3>& control_points){
+    control_points_ = control_points;
+    BuildLookupTable();
+}
+
+size_t SplinePath::segment_count() const{
+    size_t count = control_points_.size();
+    if(type_ == SplineType::BEZIER)
+        return count < 4 ? 0 : (count - 1) / 3;
+    return count < 2 ? 0 : count - 1;
+}
+
+glm::vec3 SplinePath::Evaluate(float t) const{
+    return EvaluateParameter(constant_speed_ ? ParameterAt(t) : t);
+}
+
+glm::vec3 SplinePath::EvaluateParameter(float u) const{
+    size_t segments = segment_count();
+    if(segments == 0)
+        return control_points_.empty() ? glm::vec3(0,0,0)
+                                       : control_points_.front();
+
+    float x = glm::clamp(u, 0.0f, 1.0f) * segments;
+    size_t segment = std::min((size_t)x, segments - 1);
+    float t = x - (float)segment;
+
+    const std::vector<glm::vec3>& p = control_points_;
+    if(type_ == SplineType::BEZIER){
+        size_t i = 3 * segment;
+        return Bezier(p[i], p[i + 1], p[i + 2], p[i + 3], t);
+    }
+    // The end points are repeated as the missing outer neighbours.
+    size_t last = p.size() - 1;
+    return CatmullRom(p[segment == 0 ? 0 : segment - 1], p[segment],
+                      p[segment + 1], p[std::min(segment + 2, last)], t);
+}
+
+float SplinePath::ParameterAt(float t) const{
+    if(parameters_.size() < 2)
+        return t;
+    float x = glm::clamp(t, 0.0f, 1.0f) * (parameters_.size() - 1);
+    size_t i = std::min((size_t)x, parameters_.size() - 2);
+    float fraction = x - (float)i;
+    return parameters_[i] + (parameters_[i + 1] - parameters_[i]) * fraction;
+}
+
+void SplinePath::BuildLookupTable(){
+    size_t samples = segment_count() * kLookupSamplesPerSegment;
+    parameters_.clear();
+    length_ = 0.0f;
+    if(samples == 0)
+        return;
+
+    // Arc length at u = i / samples.
+    std::vector<float> lengths(samples + 1);
+    lengths[0] = 0.0f;
+    glm::vec3 previous = EvaluateParameter(0.0f);
+    for(size_t i = 1; i <= samples; i++){
+        glm::vec3 current = EvaluateParameter((float)i / samples);
+        lengths[i] = lengths[i - 1] + glm::length(current - previous);
+        previous = current;
+    }
+    length_ = lengths[samples];
+
+    // Inverted onto evenly spaced arc lengths, lookups need no search.
+    parameters_.resize(samples + 1);
+    size_t i = 0;
+    for(size_t j = 0; j <= samples; j++){
+        float distance = length_ * (float)j / samples;
+        while(i + 1 < samples && lengths[i + 1] < distance)
+            i++;
+        float span = lengths[i + 1] - lengths[i];
+        float fraction = span > 0.0f ?
+                         glm::clamp((distance - lengths[i]) / span,
+                                    0.0f, 1.0f) : 0.0f;
+        parameters_[j] = ((float)i + fraction) / samples;
+    }
+}
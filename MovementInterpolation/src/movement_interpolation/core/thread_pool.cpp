@@ -0,0 +1,138 @@
+#include "movement_interpolation/core/thread_pool.h"
+#include "movement_interpolation/core/trace.h"
+
+#include <algorithm>
+
+namespace {
+
+// Pool and queue of the worker running on this thread, if any.
+thread_local ThreadPool* current_pool = nullptr;
+thread_local size_t current_queue = 0;
+
+}
+
+ThreadPool::ThreadPool(unsigned int thread_count) :
+        next_queue_(0),
+        pending_(0),
+        active_(0),
+        stop_(false){
+    if(thread_count == 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    queues_.reserve(thread_count);
+    for(unsigned int i = 0; i < thread_count; i++)
+        queues_.emplace_back(new WorkerQueue());
+    workers_.reserve(thread_count);
+    for(unsigned int i = 0; i < thread_count; i++)
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this, (size_t)i);
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    task_condition_.notify_all();
+    for(auto& worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task){
+    size_t index = current_pool == this
+                   ? current_queue : next_queue_++ % queues_.size();
+    // Counted before it is visible, a worker never sees it uncounted.
+    pending_++;
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    // Pairs with the predicate check of a worker about to sleep.
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    task_condition_.notify_one();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t)>& body){
+    if(count == 0)
+        return;
+    if(grain == 0)
+        grain = 1;
+    size_t chunks = (count + grain - 1) / grain;
+
+    std::mutex done_mutex;
+    std::condition_variable done_condition;
+    size_t remaining = chunks;
+
+    for(size_t chunk = 0; chunk < chunks; chunk++){
+        size_t begin = chunk * grain;
+        size_t end = std::min(count, begin + grain);
+        Submit([&, begin, end](){
+            body(begin, end);
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if(--remaining == 0)
+                done_condition.notify_one();
+        });
+    }
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_condition.wait(lock, [&remaining](){return remaining == 0;});
+}
+
+void ThreadPool::Wait(){
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_condition_.wait(lock, [this](){
+        return pending_ == 0 && active_ == 0;
+    });
+}
+
+bool ThreadPool::TryPop(size_t index, std::function<void()>& task){
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if(queue.tasks.empty())
+        return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::TrySteal(size_t index, std::function<void()>& task){
+    for(size_t i = 1; i < queues_.size(); i++){
+        WorkerQueue& queue = *queues_[(index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.tasks.empty())
+            continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(size_t index){
+    current_pool = this;
+    current_queue = index;
+    TRACE_THREAD_NAME("ThreadPool worker");
+    while(true){
+        std::function<void()> task;
+        if(!TryPop(index, task) && !TrySteal(index, task)){
+            std::unique_lock<std::mutex> lock(mutex_);
+            task_condition_.wait(lock, [this](){
+                return stop_ || pending_ > 0;
+            });
+            if(stop_ && pending_ == 0)
+                return;
+            // Counted but not pushed yet, or taken by another worker.
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+        active_++;
+        pending_--;
+        task();
+        active_--;
+        if(pending_ == 0 && active_ == 0){
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_condition_.notify_all();
+        }
+    }
+}
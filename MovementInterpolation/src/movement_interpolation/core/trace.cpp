@@ -0,0 +1,174 @@
+#include "movement_interpolation/core/trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceSlot {
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> begin;
+    std::atomic<uint64_t> duration;
+};
+
+/**
+ * Single writer ring buffer. writing is advanced before a slot is
+ * overwritten and head after, so a reader can tell which of the events
+ * it copied may have been overwritten meanwhile (a seqlock per buffer).
+ */
+struct ThreadBuffer {
+    ThreadBuffer(uint32_t thread_id) :
+            thread_id(thread_id),
+            name(nullptr),
+            slots(new TraceSlot[TraceRecorder::kEventsPerThread]),
+            writing(0),
+            head(0){}
+
+    uint32_t thread_id;
+    std::atomic<const char*> name;
+    std::unique_ptr<TraceSlot[]> slots;
+    std::atomic<uint64_t> writing;
+    std::atomic<uint64_t> head;
+};
+
+struct TraceEvent {
+    const char* name;
+    uint64_t begin;
+    uint64_t duration;
+};
+
+/**
+ * Buffers outlive their threads, events of finished threads stay
+ * available until the process exits.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& GetRegistry(){
+    static Registry registry;
+    return registry;
+}
+
+thread_local ThreadBuffer* thread_buffer = nullptr;
+
+ThreadBuffer& GetThreadBuffer(){
+    if(!thread_buffer){
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.buffers.push_back(std::make_shared<ThreadBuffer>(
+                (uint32_t)registry.buffers.size() + 1));
+        thread_buffer = registry.buffers.back().get();
+    }
+    return *thread_buffer;
+}
+
+void CopyEvents(const ThreadBuffer& buffer, std::vector<TraceEvent>& events){
+    const uint64_t capacity = TraceRecorder::kEventsPerThread;
+    uint64_t head = buffer.head.load(std::memory_order_acquire);
+    uint64_t first = head > capacity ? head - capacity : 0;
+    size_t copied = events.size();
+    for(uint64_t i = first; i < head; i++){
+        const TraceSlot& slot = buffer.slots[i % capacity];
+        TraceEvent event;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.begin = slot.begin.load(std::memory_order_relaxed);
+        event.duration = slot.duration.load(std::memory_order_relaxed);
+        events.push_back(event);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t writing = buffer.writing.load(std::memory_order_relaxed);
+    // Events before valid_first may have been overwritten while copying.
+    uint64_t valid_first = writing > capacity ? writing - capacity : 0;
+    if(valid_first > first){
+        size_t dropped = (size_t)std::min(valid_first - first, head - first);
+        events.erase(events.begin() + copied,
+                     events.begin() + copied + dropped);
+    }
+}
+
+void WriteJsonString(FILE* file, const char* text){
+    std::fputc('"', file);
+    for(const char* c = text; *c; c++){
+        if(*c == '"' || *c == '\\')
+            std::fputc('\\', file);
+        std::fputc(*c, file);
+    }
+    std::fputc('"', file);
+}
+
+}
+
+const size_t TraceRecorder::kEventsPerThread;
+
+uint64_t TraceRecorder::Now(){
+    static const std::chrono::steady_clock::time_point epoch
+            = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count();
+}
+
+void TraceRecorder::Record(const char* name, uint64_t begin, uint64_t end){
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint64_t index = buffer.head.load(std::memory_order_relaxed);
+    buffer.writing.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    TraceSlot& slot = buffer.slots[index % kEventsPerThread];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.duration.store(end - begin, std::memory_order_relaxed);
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::SetThreadName(const char* name){
+    GetThreadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+bool TraceRecorder::WriteChromeTrace(const std::string& path){
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffers = registry.buffers;
+    }
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if(!file)
+        return false;
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    std::vector<TraceEvent> events;
+    for(const std::shared_ptr<ThreadBuffer>& buffer : buffers){
+        const char* thread_name
+                = buffer->name.load(std::memory_order_relaxed);
+        if(thread_name){
+            std::fprintf(file, "%s\n{\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                               "\"name\":\"thread_name\",\"args\":{\"name\":",
+                         first ? "" : ",", buffer->thread_id);
+            WriteJsonString(file, thread_name);
+            std::fprintf(file, "}}");
+            first = false;
+        }
+
+        events.clear();
+        CopyEvents(*buffer, events);
+        for(const TraceEvent& event : events){
+            std::fprintf(file, "%s\n{\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                               "\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                         first ? "" : ",", buffer->thread_id,
+                         event.begin / 1000.0, event.duration / 1000.0);
+            WriteJsonString(file, event.name);
+            std::fprintf(file, "}");
+            first = false;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,106 @@
+#include "movement_interpolation/core/trajectory_reader.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+const size_t kSampleSize = TrajectoryWriter::kFloatsPerSample * 4;
+
+uint64_t GetUint(const unsigned char* data, int bytes){
+    uint64_t value = 0;
+    for(int i = 0; i < bytes; i++)
+        value |= (uint64_t)data[i] << (8 * i);
+    return value;
+}
+
+float GetFloat(const unsigned char* data){
+    uint32_t bits = (uint32_t)GetUint(data, 4);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+struct FileCloser {
+    void operator()(FILE* file) const {std::fclose(file);}
+};
+
+}
+
+bool ReadTrajectory(const std::string& path,
+                    std::vector<TrajectorySample>& samples,
+                    float& simulation_length, std::string& error){
+    samples.clear();
+    std::unique_ptr<FILE, FileCloser> file(std::fopen(path.c_str(), "rb"));
+    if(!file){
+        error = "Could not open " + path;
+        return false;
+    }
+
+    unsigned char header[TrajectoryWriter::kHeaderSize];
+    if(std::fread(header, 1, sizeof(header), file.get()) != sizeof(header)
+       || std::memcmp(header, "MITR", 4) != 0){
+        error = path + " is not a binary trajectory";
+        return false;
+    }
+    if(GetUint(header + 4, 2) != TrajectoryWriter::kTrajectoryVersion
+       || GetUint(header + 6, 2) != TrajectoryWriter::kFloatsPerSample){
+        error = path + " has an unsupported version";
+        return false;
+    }
+    uint64_t count = GetUint(header + 8, 8);
+    simulation_length = GetFloat(header + 16);
+
+    // The count is checked against the file before reserving for it, a
+    // corrupt header must not allocate.
+    long file_size = -1;
+    if(std::fseek(file.get(), 0, SEEK_END) == 0)
+        file_size = std::ftell(file.get());
+    if(file_size < (long)sizeof(header) ||
+       std::fseek(file.get(), (long)sizeof(header), SEEK_SET) != 0){
+        error = "Could not read " + path;
+        return false;
+    }
+    uint64_t stored = ((uint64_t)file_size - sizeof(header)) / kSampleSize;
+    if(count > stored){
+        error = path + " is truncated";
+        return false;
+    }
+    if(count > 0)
+        samples.reserve((size_t)count);
+
+    // Samples are read in chunks through a fixed size buffer.
+    const size_t kChunkSamples = 4096;
+    std::vector<unsigned char> buffer(kChunkSamples * kSampleSize);
+    while(count == 0 || samples.size() < count){
+        size_t read = std::fread(buffer.data(), kSampleSize, kChunkSamples,
+                                 file.get());
+        for(size_t i = 0; i < read; i++){
+            const unsigned char* data = buffer.data() + i * kSampleSize;
+            TrajectorySample sample;
+            sample.time = GetFloat(data);
+            sample.position = glm::vec3(GetFloat(data + 4),
+                                        GetFloat(data + 8),
+                                        GetFloat(data + 12));
+            sample.euler_angles = glm::vec3(GetFloat(data + 16),
+                                            GetFloat(data + 20),
+                                            GetFloat(data + 24));
+            sample.quaternion = glm::quat(GetFloat(data + 28),
+                                          GetFloat(data + 32),
+                                          GetFloat(data + 36),
+                                          GetFloat(data + 40));
+            samples.push_back(sample);
+        }
+        if(read < kChunkSamples)
+            break;
+    }
+    if(count > 0 && samples.size() < count){
+        error = path + " is truncated";
+        return false;
+    }
+    if(count > 0)
+        samples.resize((size_t)count);
+    return true;
+}
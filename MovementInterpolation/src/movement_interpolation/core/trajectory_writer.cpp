@@ -0,0 +1,171 @@
+#include "movement_interpolation/core/trajectory_writer.h"
+#include "movement_interpolation/core/interpolation_policy.h"
+
+#include <cstring>
+
+namespace {
+// Longest CSV line, 11 "%.9g" floats with separators.
+const size_t kMaxCsvLine = 11 * 17 + 1;
+
+struct ExportVisitor {
+    ExportVisitor(int count, float simulation_length,
+                  TrajectoryWriter& writer, bool& success) :
+            count(count), simulation_length(simulation_length),
+            writer(writer), success(success){}
+
+    template<class Kernel>
+    void operator()(const Kernel& kernel) const {
+        TrajectorySample sample;
+        for(int i = 0; i < count && success; i++){
+            float t = (float) i / (float) count;
+            sample.time = t * simulation_length;
+            sample.position = kernel.Position(t);
+            sample.euler_angles = kernel.EulerAngles(t);
+            sample.quaternion = kernel.Quaternion(t);
+            success = writer.Write(sample);
+        }
+    }
+
+    int count;
+    float simulation_length;
+    TrajectoryWriter& writer;
+    bool& success;
+};
+}
+
+TrajectoryWriter::TrajectoryWriter(size_t buffer_size) :
+        file_(nullptr),
+        format_(TrajectoryFormat::BINARY),
+        buffer_(buffer_size < kMaxCsvLine ? kMaxCsvLine : buffer_size),
+        used_(0),
+        samples_written_(0),
+        failed_(false){}
+
+TrajectoryWriter::~TrajectoryWriter(){
+    Close();
+}
+
+bool TrajectoryWriter::Open(const std::string& path, TrajectoryFormat format,
+                            float simulation_length){
+    Close();
+    file_ = std::fopen(path.c_str(), format == TrajectoryFormat::BINARY ?
+                                     "wb" : "w");
+    if(!file_)
+        return false;
+    format_ = format;
+    used_ = 0;
+    samples_written_ = 0;
+    failed_ = false;
+
+    if(format_ == TrajectoryFormat::CSV){
+        const char* header = "time,position_x,position_y,position_z,"
+                "euler_x,euler_y,euler_z,"
+                "quaternion_w,quaternion_x,quaternion_y,quaternion_z\n";
+        size_t length = std::strlen(header);
+        std::memcpy(buffer_.data(), header, length);
+        used_ = length;
+        return true;
+    }
+    const char magic[4] = {'M', 'I', 'T', 'R'};
+    std::memcpy(buffer_.data(), magic, sizeof(magic));
+    used_ = sizeof(magic);
+    PutUint16(kTrajectoryVersion);
+    PutUint16((uint16_t)kFloatsPerSample);
+    PutUint64(0);
+    PutFloat(simulation_length);
+    std::memset(buffer_.data() + used_, 0, kHeaderSize - used_);
+    used_ = kHeaderSize;
+    return true;
+}
+
+bool TrajectoryWriter::Write(const TrajectorySample& sample){
+    if(!file_)
+        return false;
+    if(format_ == TrajectoryFormat::CSV){
+        Reserve(kMaxCsvLine);
+        int length = std::snprintf(
+                (char*)buffer_.data() + used_, kMaxCsvLine,
+                "%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g\n",
+                sample.time,
+                sample.position.x, sample.position.y, sample.position.z,
+                sample.euler_angles.x, sample.euler_angles.y,
+                sample.euler_angles.z,
+                sample.quaternion.w, sample.quaternion.x,
+                sample.quaternion.y, sample.quaternion.z);
+        if(length > 0)
+            used_ += (size_t)length;
+    }
+    else{
+        Reserve(kFloatsPerSample * sizeof(float));
+        PutFloat(sample.time);
+        PutFloat(sample.position.x);
+        PutFloat(sample.position.y);
+        PutFloat(sample.position.z);
+        PutFloat(sample.euler_angles.x);
+        PutFloat(sample.euler_angles.y);
+        PutFloat(sample.euler_angles.z);
+        PutFloat(sample.quaternion.w);
+        PutFloat(sample.quaternion.x);
+        PutFloat(sample.quaternion.y);
+        PutFloat(sample.quaternion.z);
+    }
+    samples_written_++;
+    return !failed_;
+}
+
+bool TrajectoryWriter::Close(){
+    if(!file_)
+        return false;
+    Flush();
+    if(format_ == TrajectoryFormat::BINARY &&
+       std::fseek(file_, 8, SEEK_SET) == 0){
+        used_ = 0;
+        PutUint64(samples_written_);
+        Flush();
+    }
+    if(std::fclose(file_) != 0)
+        failed_ = true;
+    file_ = nullptr;
+    return !failed_;
+}
+
+bool TrajectoryWriter::Flush(){
+    if(used_ > 0 && std::fwrite(buffer_.data(), 1, used_, file_) != used_)
+        failed_ = true;
+    used_ = 0;
+    return !failed_;
+}
+
+void TrajectoryWriter::Reserve(size_t bytes){
+    if(used_ + bytes > buffer_.size())
+        Flush();
+}
+
+void TrajectoryWriter::PutUint16(uint16_t value){
+    buffer_[used_++] = (unsigned char)(value);
+    buffer_[used_++] = (unsigned char)(value >> 8);
+}
+
+void TrajectoryWriter::PutUint32(uint32_t value){
+    for(int i = 0; i < 4; i++)
+        buffer_[used_++] = (unsigned char)(value >> (8 * i));
+}
+
+void TrajectoryWriter::PutUint64(uint64_t value){
+    for(int i = 0; i < 8; i++)
+        buffer_[used_++] = (unsigned char)(value >> (8 * i));
+}
+
+void TrajectoryWriter::PutFloat(float value){
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    PutUint32(bits);
+}
+
+bool ExportTrajectory(const Interpolator& interpolator, int count,
+                      float simulation_length, TrajectoryWriter& writer){
+    bool success = true;
+    DispatchInterpolation(interpolator, ExportVisitor(count, simulation_length,
+                                                      writer, success));
+    return success;
+}
@@ -2,18 +2,46 @@
 
 #include "movement_interpolation/gui/movement_interpolation_gui.h"
 #include <movement_interpolation/interpolation_simulation.h>
+#include "movement_interpolation/core/trace.h"
+#include "movement_interpolation/allocation_counter.h"
 
 #include "engine_gui/engine_gui.h"
 #include "engine_gui/factory/engine_gui_factory.h"
 
 #include <gui/imgui/imgui.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+const char* const kTracePath = "trace.json";
+
+void LatencyText(const char* label, const LatencyPercentiles& latency){
+    ImGui::Text("%s p50/p95/p99: %.3f / %.3f / %.3f [ms]", label,
+                latency.p50 * 1000.0f, latency.p95 * 1000.0f,
+                latency.p99 * 1000.0f);
+}
+}
+
 MovementInterpolationGUI::MovementInterpolationGUI(
         GLFWwindow* window,
         std::shared_ptr<ifx::Renderer> renderer,
         std::shared_ptr<InterpolationSimulation> simulation) :
         ifx::GUI(window),
-        simulation_(simulation){
+        simulation_(simulation),
+        scene_dirty_(true),
+        export_csv_(false),
+        spline_enabled_(false),
+        spline_type_(SplineType::CATMULL_ROM),
+        spline_constant_speed_(true),
+        trace_dumped_(false),
+        trace_written_(false),
+        allocation_count_(AllocationCount()),
+        frame_allocations_(0){
+    std::strncpy(export_path_, "trajectory.mitr", sizeof(export_path_));
     engine_gui_ = ifx::EngineGUIFactory().CreateEngineGUI(renderer);
 
     InitSimulationCreateParams();
@@ -22,12 +50,22 @@ MovementInterpolationGUI::MovementInterpolationGUI(
 MovementInterpolationGUI::~MovementInterpolationGUI(){}
 
 void MovementInterpolationGUI::Render(){
+    TRACE_SCOPE("MovementInterpolationGUI::Render");
+    // Everything allocated since the previous frame, on all threads.
+    unsigned long long allocation_count = AllocationCount();
+    frame_allocations_ = allocation_count - allocation_count_;
+    allocation_count_ = allocation_count;
+
+    std::chrono::steady_clock::time_point begin
+            = std::chrono::steady_clock::now();
     NewFrame();
 
     RenderGUI();
     engine_gui_->Render();
 
     ImGui::Render();
+    gui_latency_.Add(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - begin).count());
 }
 
 void MovementInterpolationGUI::RenderGUI(){
@@ -43,11 +81,12 @@ void MovementInterpolationGUI::RenderGUI(){
 void MovementInterpolationGUI::RenderSimulationInfo(){
     ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
 
-    ImGui::Text("Time: %.2f [s]", simulation_->time_data().total_time);
+    const SimulationState& state = simulation_->state();
+    ImGui::Text("Time: %.2f [s]", state.total_time);
     ImGui::SameLine();
     ImGui::PushItemWidth(100);
-    ImGui::ProgressBar(simulation_->time_data().total_time /
-                               simulation_->time_data().simulation_length);
+    ImGui::ProgressBar(state.simulation_length > 0.0f
+                       ? state.total_time / state.simulation_length : 1.0f);
     ImGui::PopItemWidth();
 
     ImGui::PushItemWidth(100);
@@ -71,156 +110,285 @@ void MovementInterpolationGUI::RenderSimulationInfo(){
 
     static int frames_count = 15;
 
-    if (ImGui::Button("Render All Frames")) {
+    if(simulation_->IsSimulatingFrames()){
+        if (ImGui::Button("Cancel")) {
+            simulation_->CancelSimulateFrames();
+        }
+        ImGui::SameLine();
+        ImGui::PushItemWidth(100);
+        ImGui::ProgressBar(simulation_->simulate_frames_progress());
+        ImGui::PopItemWidth();
+    }
+    else if (ImGui::Button("Render All Frames")) {
         simulation_->SimulateFrames(frames_count, simulation_create_param_);
     }
     ImGui::SameLine();
     ImGui::PushItemWidth(100);
     ImGui::InputInt("Frames Count", &frames_count);
     ImGui::PopItemWidth();
+    RenderFrameSamplingMode();
+
+    RenderExport(frames_count);
+    RenderBlendWeights();
+
+    bool run_on_thread = simulation_->runs_on_thread();
+    if(ImGui::Checkbox("Simulation Thread", &run_on_thread))
+        simulation_->RunOnThread(run_on_thread);
+
+    if(kTraceEnabled && ImGui::Button("Dump Trace")){
+        trace_written_ = TraceRecorder::WriteChromeTrace(kTracePath);
+        trace_dumped_ = true;
+    }
+    if(trace_dumped_){
+        ImGui::SameLine();
+        ImGui::Text(trace_written_ ? "Trace written to %s"
+                                   : "Could not write %s", kTracePath);
+    }
+
+    bool euler_diagnostics = simulation_->euler_diagnostics();
+    if(ImGui::Checkbox("Quaternion Euler Angles", &euler_diagnostics))
+        simulation_->euler_diagnostics(euler_diagnostics);
+    if(euler_diagnostics){
+        const glm::vec3& euler = simulation_->quaternion_euler();
+        ImGui::Text("[%.1f, %.1f, %.1f]", euler.x, euler.y, euler.z);
+    }
+    if(ImGui::CollapsingHeader("Performance"))
+        RenderPerformance();
+}
+
+void MovementInterpolationGUI::RenderPerformance(){
+    const SimulationState& state = simulation_->state();
+    LatencyText("Step", state.step_latency);
+    LatencyText("GUI", gui_latency_.Percentiles());
+    LatencyText("Simulate Frames", state.simulate_frames_latency);
+
+    ImGui::Text("Fixed steps: %llu taken, %llu dropped",
+                state.steps_taken, state.steps_dropped);
+    const GhostTrail& ghost_trail = simulation_->ghost_trail();
+    ImGui::Text("Ghosts: %zu, %.1f / %.1f [KiB]", ghost_trail.size(),
+                ghost_trail.size_bytes() / 1024.0f,
+                ghost_trail.capacity_bytes() / 1024.0f);
+    ImGui::Text("Allocations: %llu last frame", frame_allocations_);
+    if(simulation_->pending_command_count() > 0){
+        ImGui::Text("Command queue full, %zu waiting",
+                    simulation_->pending_command_count());
+    }
+}
+
+void MovementInterpolationGUI::RenderFrameSamplingMode(){
+    int mode = (int)simulation_->frame_sampling_mode();
+    bool changed = false;
+    changed |= ImGui::RadioButton("Exact", &mode,
+                                  (int)FrameSamplingMode::EXACT);
+    ImGui::SameLine();
+    changed |= ImGui::RadioButton("Incremental", &mode,
+                                  (int)FrameSamplingMode::INCREMENTAL);
+    ImGui::SameLine();
+    changed |= ImGui::RadioButton("Adaptive", &mode,
+                                  (int)FrameSamplingMode::ADAPTIVE);
+    if(changed)
+        simulation_->frame_sampling_mode((FrameSamplingMode)mode);
+
+    if(simulation_->frame_sampling_mode() != FrameSamplingMode::ADAPTIVE)
+        return;
+    // Frames Count is the upper bound of adaptive sampling.
+    AdaptiveTolerance& tolerance = simulation_->adaptive_tolerance();
+    ImGui::PushItemWidth(100);
+    ImGui::InputFloat("Position Tolerance", &tolerance.position);
+    ImGui::InputFloat("Angle Tolerance [deg]", &tolerance.angle_degrees);
+    ImGui::PopItemWidth();
+    tolerance.position = std::max(tolerance.position, 1e-5f);
+    tolerance.angle_degrees = std::max(tolerance.angle_degrees, 1e-3f);
+}
+
+void MovementInterpolationGUI::RenderExport(int frames_count){
+    if(simulation_->export_status() == ExportStatus::RUNNING){
+        ImGui::Text("Exporting...");
+    }
+    else if(ImGui::Button("Export Frames")){
+        simulation_->ExportFrames(frames_count, simulation_create_param_,
+                                  export_path_,
+                                  export_csv_ ? TrajectoryFormat::CSV :
+                                  TrajectoryFormat::BINARY);
+    }
+    ImGui::SameLine();
+    ImGui::PushItemWidth(150);
+    ImGui::InputText("##ExportPath", export_path_, sizeof(export_path_));
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    ImGui::Checkbox("CSV", &export_csv_);
+
+    if(simulation_->export_status() == ExportStatus::DONE)
+        ImGui::Text("Exported to %s", export_path_);
+    if(simulation_->export_status() == ExportStatus::FAILED)
+        ImGui::Text("Export to %s failed", export_path_);
+}
+
+void MovementInterpolationGUI::RenderBlendWeights(){
+    if(simulation_->blend_input_count() == 0)
+        return;
+    ImGui::Text("Blend Weights");
+    ImGui::PushItemWidth(150);
+    for(size_t i = 0; i < simulation_->blend_input_count(); i++){
+        float weight = simulation_->blend_weight(i);
+        // Formatted on the stack, the panel should not allocate per frame.
+        char label[32];
+        std::snprintf(label, sizeof(label), "Track %zu", i);
+        if(ImGui::SliderFloat(label, &weight, 0.0f, 1.0f))
+            simulation_->SetBlendWeight(i, weight);
+    }
+    ImGui::PopItemWidth();
 }
 
 void MovementInterpolationGUI::RenderInterpolationInfo(){
+    bool position_changed = false;
+    bool euler_changed = false;
+    bool quaternion_changed = false;
+
     if(ImGui::TreeNode("Position")){
-        RenderBeginPosition();
-        RenderEndPosition();
+        position_changed |= RenderBeginPosition();
+        position_changed |= RenderEndPosition();
+        bool spline_changed = RenderSplinePath();
         ImGui::TreePop();
+
+        if(position_changed || spline_changed)
+            UpdateSplinePath();
     }
     if(ImGui::TreeNode("Euler Angles Degrees [x,y,z] ")){
-        RenderBeginEulerAngles();
-        RenderEndEulerAngles();
+        euler_changed |= RenderBeginEulerAngles();
+        euler_changed |= RenderEndEulerAngles();
         ImGui::TreePop();
-
-        TransformEulerToQuaternion();
     }
     if(ImGui::TreeNode("Quaternions [w,x,y,z]")){
         RenderQuaternionInterpolationType();
-        RenderBeginQuaternionAngles();
-        RenderEndQuaternionAngles();
+        quaternion_changed |= RenderBeginQuaternionAngles();
+        quaternion_changed |= RenderEndQuaternionAngles();
         ImGui::TreePop();
+    }
 
+    if(euler_changed)
+        TransformEulerToQuaternion();
+    if(quaternion_changed)
         TransformQuaternionToEuler();
-    }
 
-    simulation_->UpdatePosition(simulation_create_param_);
+    // The begin/end objects only move when a widget was edited.
+    if(position_changed || euler_changed || quaternion_changed
+       || scene_dirty_){
+        simulation_->UpdatePosition(simulation_create_param_);
+        scene_dirty_ = false;
+    }
 }
 
-void MovementInterpolationGUI::RenderBeginPosition(){
-    static float raw[3];
-
-    raw[0] = simulation_create_param_->interpolation_data.position_begin.x;
-    raw[1] = simulation_create_param_->interpolation_data.position_begin.y;
-    raw[2] = simulation_create_param_->interpolation_data.position_begin.z;
+bool MovementInterpolationGUI::RenderSplinePath(){
+    bool changed = ImGui::Checkbox("Spline Path", &spline_enabled_);
+    if(!spline_enabled_)
+        return changed;
 
-    ImGui::SliderFloat3("Begin Position", raw, -10, 10);
+    int type = (int)spline_type_;
+    changed |= ImGui::RadioButton("Catmull-Rom", &type,
+                                  (int)SplineType::CATMULL_ROM);
+    ImGui::SameLine();
+    changed |= ImGui::RadioButton("Bezier", &type, (int)SplineType::BEZIER);
+    spline_type_ = (SplineType)type;
+    ImGui::SameLine();
+    changed |= ImGui::Checkbox("Constant Speed", &spline_constant_speed_);
 
-    simulation_create_param_->interpolation_data.position_begin.x = raw[0];
-    simulation_create_param_->interpolation_data.position_begin.y = raw[1];
-    simulation_create_param_->interpolation_data.position_begin.z = raw[2];
+    changed |= ImGui::SliderFloat3("Control Point 1",
+                                   &spline_control_points_[0].x, -10, 10);
+    changed |= ImGui::SliderFloat3("Control Point 2",
+                                   &spline_control_points_[1].x, -10, 10);
+    return changed;
 }
 
-void MovementInterpolationGUI::RenderEndPosition(){
-    static float raw[3];
-
-    raw[0] = simulation_create_param_->interpolation_data.position_end.x;
-    raw[1] = simulation_create_param_->interpolation_data.position_end.y;
-    raw[2] = simulation_create_param_->interpolation_data.position_end.z;
-
-    ImGui::SliderFloat3("End Position", raw, -10, 10);
-
-    simulation_create_param_->interpolation_data.position_end.x = raw[0];
-    simulation_create_param_->interpolation_data.position_end.y = raw[1];
-    simulation_create_param_->interpolation_data.position_end.z = raw[2];
+void MovementInterpolationGUI::UpdateSplinePath(){
+    InterpolationData& data = simulation_create_param_->interpolation_data;
+    if(!spline_enabled_){
+        data.position_path = nullptr;
+        return;
+    }
+    // A new path each time, the simulation may still use the previous one.
+    std::vector<glm::vec3> control_points = {
+            data.position_begin,
+            spline_control_points_[0], spline_control_points_[1],
+            data.position_end};
+    auto path = std::make_shared<SplinePath>(spline_type_, control_points);
+    path->constant_speed(spline_constant_speed_);
+    data.position_path = path;
 }
 
-void MovementInterpolationGUI::RenderBeginEulerAngles(){
-    static float raw[3];
-
-    raw[0] = simulation_create_param_->interpolation_data.euler_begin.x;
-    raw[1] = simulation_create_param_->interpolation_data.euler_begin.y;
-    raw[2] = simulation_create_param_->interpolation_data.euler_begin.z;
-
-    ImGui::SliderFloat3("Begin Euler Angles", raw, 0, 360);
-
-    simulation_create_param_->interpolation_data.euler_begin.x = raw[0];
-    simulation_create_param_->interpolation_data.euler_begin.y = raw[1];
-    simulation_create_param_->interpolation_data.euler_begin.z = raw[2];
+bool MovementInterpolationGUI::RenderBeginPosition(){
+    return ImGui::SliderFloat3(
+            "Begin Position",
+            &simulation_create_param_->interpolation_data.position_begin.x,
+            -10, 10);
 }
 
-void MovementInterpolationGUI::RenderEndEulerAngles(){
-    static float raw[3];
-
-    raw[0] = simulation_create_param_->interpolation_data.euler_end.x;
-    raw[1] = simulation_create_param_->interpolation_data.euler_end.y;
-    raw[2] = simulation_create_param_->interpolation_data.euler_end.z;
+bool MovementInterpolationGUI::RenderEndPosition(){
+    return ImGui::SliderFloat3(
+            "End Position",
+            &simulation_create_param_->interpolation_data.position_end.x,
+            -10, 10);
+}
 
-    ImGui::SliderFloat3("End Euler Angles", raw, 0, 360);
+bool MovementInterpolationGUI::RenderBeginEulerAngles(){
+    return ImGui::SliderFloat3(
+            "Begin Euler Angles",
+            &simulation_create_param_->interpolation_data.euler_begin.x,
+            0, 360);
+}
 
-    simulation_create_param_->interpolation_data.euler_end.x = raw[0];
-    simulation_create_param_->interpolation_data.euler_end.y = raw[1];
-    simulation_create_param_->interpolation_data.euler_end.z = raw[2];
+bool MovementInterpolationGUI::RenderEndEulerAngles(){
+    return ImGui::SliderFloat3(
+            "End Euler Angles",
+            &simulation_create_param_->interpolation_data.euler_end.x,
+            0, 360);
 }
 
 void MovementInterpolationGUI::RenderQuaternionInterpolationType(){
-    static int e = 0;
-
-    if(simulation_create_param_->interpolation_data.interpolation_method ==
-       InterpolationMethod::LERP)
-        e = 0;
-    if(simulation_create_param_->interpolation_data.interpolation_method ==
-       InterpolationMethod::SLERP)
+    InterpolationMethod& method
+            = simulation_create_param_->interpolation_data.interpolation_method;
+    int e = 0;
+    if(method == InterpolationMethod::SLERP)
         e = 1;
-
-    ImGui::RadioButton("Lerp", &e, 0); ImGui::SameLine();
-    ImGui::RadioButton("Slerp", &e, 1);
-
-    if(e == 0){
-        simulation_create_param_->interpolation_data.interpolation_method
-                = InterpolationMethod::LERP;
-    }
-    if(e == 1){
-        simulation_create_param_->interpolation_data.interpolation_method
-                = InterpolationMethod::SLERP;
-    }
-
+    if(method == InterpolationMethod::FAST_SLERP)
+        e = 2;
+
+    bool changed = false;
+    changed |= ImGui::RadioButton("Lerp", &e, 0); ImGui::SameLine();
+    changed |= ImGui::RadioButton("Slerp", &e, 1); ImGui::SameLine();
+    changed |= ImGui::RadioButton("Fast Slerp", &e, 2);
+    if(!changed)
+        return;
+
+    if(e == 0)
+        method = InterpolationMethod::LERP;
+    if(e == 1)
+        method = InterpolationMethod::SLERP;
+    if(e == 2)
+        method = InterpolationMethod::FAST_SLERP;
 }
 
-void MovementInterpolationGUI::RenderBeginQuaternionAngles(){
-    static float raw[4];
-
-    raw[0] = simulation_create_param_->interpolation_data.quaternion_begin.w;
-    raw[1] = simulation_create_param_->interpolation_data.quaternion_begin.x;
-    raw[2] = simulation_create_param_->interpolation_data.quaternion_begin.y;
-    raw[3] = simulation_create_param_->interpolation_data.quaternion_begin.z;
-
-    ImGui::SliderFloat4("Begin Quaternion", raw, -2, 2);
-
-    simulation_create_param_->interpolation_data.quaternion_begin.w = raw[0];
-    simulation_create_param_->interpolation_data.quaternion_begin.x = raw[1];
-    simulation_create_param_->interpolation_data.quaternion_begin.y = raw[2];
-    simulation_create_param_->interpolation_data.quaternion_begin.z = raw[3];
-
-    simulation_create_param_->interpolation_data.quaternion_begin
-            = glm::normalize(simulation_create_param_->interpolation_data.quaternion_begin);
+bool MovementInterpolationGUI::RenderBeginQuaternionAngles(){
+    return RenderQuaternion(
+            "Begin Quaternion",
+            simulation_create_param_->interpolation_data.quaternion_begin);
 }
 
-void MovementInterpolationGUI::RenderEndQuaternionAngles(){
-    static float raw[4];
-
-    raw[0] = simulation_create_param_->interpolation_data.quaternion_end.w;
-    raw[1] = simulation_create_param_->interpolation_data.quaternion_end.x;
-    raw[2] = simulation_create_param_->interpolation_data.quaternion_end.y;
-    raw[3] = simulation_create_param_->interpolation_data.quaternion_end.z;
-
-    ImGui::SliderFloat4("End Quaternion", raw, -2, 2);
+bool MovementInterpolationGUI::RenderEndQuaternionAngles(){
+    return RenderQuaternion(
+            "End Quaternion",
+            simulation_create_param_->interpolation_data.quaternion_end);
+}
 
-    simulation_create_param_->interpolation_data.quaternion_end.w = raw[0];
-    simulation_create_param_->interpolation_data.quaternion_end.x = raw[1];
-    simulation_create_param_->interpolation_data.quaternion_end.y = raw[2];
-    simulation_create_param_->interpolation_data.quaternion_end.z = raw[3];
+bool MovementInterpolationGUI::RenderQuaternion(const char* label,
+                                                glm::quat& quaternion){
+    // The widget shows [w,x,y,z], glm stores the quaternion as [x,y,z,w].
+    float raw[4] = {quaternion.w, quaternion.x, quaternion.y, quaternion.z};
+    if(!ImGui::SliderFloat4(label, raw, -2, 2))
+        return false;
 
-    simulation_create_param_->interpolation_data.quaternion_end
-            = glm::normalize(simulation_create_param_->interpolation_data.quaternion_end);
+    quaternion = glm::normalize(glm::quat(raw[0], raw[1], raw[2], raw[3]));
+    return true;
 }
 
 void MovementInterpolationGUI::InitSimulationCreateParams(){
@@ -249,6 +417,13 @@ void MovementInterpolationGUI::InitSimulationCreateParams(){
 
     simulation_create_param_->simulation_length_s
             = simulation_->time_data().simulation_length;
+
+    const InterpolationData& data = simulation_create_param_->interpolation_data;
+    glm::vec3 direction = data.position_end - data.position_begin;
+    spline_control_points_[0] = data.position_begin + direction / 3.0f
+                                + glm::vec3(0, 1, 0);
+    spline_control_points_[1] = data.position_begin + direction * 2.0f / 3.0f
+                                - glm::vec3(0, 1, 0);
 }
 
 void MovementInterpolationGUI::TransformEulerToQuaternion(){
@@ -1,41 +1,136 @@
 #include "movement_interpolation/interpolation_simulation.h"
+#include "movement_interpolation/rendering/pose_render_object.h"
+#include "movement_interpolation/rendering/ghost_trail_render_object.h"
+#include "movement_interpolation/core/thread_pool.h"
+#include "movement_interpolation/core/trace.h"
 
 #include <rendering/scene/scene.h>
 #include <rendering/renderer.h>
 #include <object/render_object.h>
-#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// Leave a core to the render thread.
+unsigned int WorkerThreadCount(){
+    unsigned int hardware_threads = std::thread::hardware_concurrency();
+    return hardware_threads > 1 ? hardware_threads - 1 : 1;
+}
+
+const size_t kCommandQueueSize = 64;
+const size_t kSamplesQueueSize = 4;
+
+SimulationCommand CreateCommand(SimulationCommandType type){
+    SimulationCommand command = SimulationCommand();
+    command.type = type;
+    return command;
+}
+
+}
 
 InterpolationSimulation::InterpolationSimulation(
         std::shared_ptr<ifx::Scene> scene,
         std::shared_ptr<ifx::Renderer> renderer,
-        std::shared_ptr<ifx::RenderObject> render_object) :
+        std::shared_ptr<ifx::RenderObject> render_object,
+        std::shared_ptr<ifx::Model> model) :
+        clock_(std::make_shared<WallClock>()),
+        scheduler_(time_data_.time_delta),
         scene_(scene),
-        renderer_(renderer){
-    InitScene(scene_, render_object);
+        renderer_(renderer),
+        thread_pool_(std::make_shared<ThreadPool>(WorkerThreadCount())),
+        frame_sampler_(thread_pool_),
+        frame_sampling_mode_(FrameSamplingMode::EXACT),
+        frames_generation_(0),
+        generation_(0),
+        export_status_(std::make_shared<std::atomic<ExportStatus>>(
+                ExportStatus::IDLE)),
+        commands_(kCommandQueueSize),
+        recycled_samples_(kSamplesQueueSize),
+        simulated_frames_(kSamplesQueueSize),
+        stop_thread_(false),
+        euler_diagnostics_(false),
+        quaternion_euler_(0,0,0){
+    InitScene(scene_, render_object, model);
     InitParameters();
-    SetRunning(false);
 }
 
-InterpolationSimulation::~InterpolationSimulation(){ }
-
-void InterpolationSimulation::SetRunning(bool value){
-    ifx::Simulation::SetRunning(value);
+InterpolationSimulation::~InterpolationSimulation(){
+    RunOnThread(false);
+}
 
+void InterpolationSimulation::RunOnThread(bool value){
+    if(value == runs_on_thread())
+        return;
     if(value){
-        render_objects.render_object_begin_->do_render(false);
-        render_objects.render_object_end_->do_render(false);
+        stop_thread_ = false;
+        thread_ = std::thread(&InterpolationSimulation::SimulationLoop, this);
+    }
+    else{
+        stop_thread_ = true;
+        thread_.join();
+    }
+}
+
+void InterpolationSimulation::SetClock(std::shared_ptr<Clock> clock){
+    clock_ = clock;
+    time_data_.last_time = clock_->Now();
+    scheduler_.Reset(time_data_.last_time);
+}
 
-        render_objects.render_object_euler_current_->do_render(true);
-        render_objects.render_object_quaternion_current_->do_render(true);
+void InterpolationSimulation::SetKeyframeTrack(
+        std::shared_ptr<KeyframeTrack> keyframe_track){
+    keyframe_track_ = keyframe_track;
+    if(keyframe_track_ && keyframe_track_->duration() > 0.0f)
+        time_data_.simulation_length = keyframe_track_->duration();
+}
+
+void InterpolationSimulation::SetSkeleton(
+        std::shared_ptr<SkeletonTrack> skeleton){
+    skeleton_ = skeleton;
+    if(skeleton_){
+        StepSkeleton(Fraction(time_data_.total_time));
     }
     else{
-        render_objects.render_object_begin_->do_render(true);
-        render_objects.render_object_end_->do_render(true);
+        simulation_state_.skeleton_pose.Resize(0);
+    }
+}
+
+void InterpolationSimulation::SetBlendTracks(
+        const std::vector<std::shared_ptr<KeyframeTrack>>& tracks){
+    blend_tracks_.clear();
+    for(const std::shared_ptr<KeyframeTrack>& track : tracks){
+        if(track && track->size() > 0)
+            blend_tracks_.push_back(track);
+    }
+    pose_blender_.Resize(blend_tracks_.size(), 1);
+    blend_weights_.assign(blend_tracks_.size(), 1.0f);
+    float duration = 0.0f;
+    for(size_t i = 0; i < blend_tracks_.size(); i++){
+        pose_blender_.weight(i, blend_weights_[i]);
+        duration = std::max(duration, blend_tracks_[i]->duration());
     }
+    if(duration > 0.0f)
+        time_data_.simulation_length = duration;
+}
+
+void InterpolationSimulation::SetBlendWeight(size_t input, float weight){
+    if(input >= blend_weights_.size())
+        return;
+    blend_weights_[input] = weight;
+
+    SimulationCommand command
+            = CreateCommand(SimulationCommandType::SET_BLEND_WEIGHT);
+    command.blend_input = (int)input;
+    command.blend_weight = weight;
+    Send(command);
 }
 
 void InterpolationSimulation::UpdatePosition(
         std::shared_ptr<InterpolationSimulationCreateParam> params){
+    TRACE_SCOPE("InterpolationSimulation::UpdatePosition");
     render_objects.render_object_begin_->moveTo(
             params->interpolation_data.position_begin);
     render_objects.render_object_end_->moveTo(
@@ -47,153 +142,368 @@ void InterpolationSimulation::UpdatePosition(
             params->interpolation_data.euler_end);
 }
 
+bool InterpolationSimulation::Post(const SimulationCommand& command){
+    bool new_generation
+            = command.type == SimulationCommandType::RESET ||
+              command.type == SimulationCommandType::SIMULATE_FRAMES;
+    SimulationCommand queued = command;
+    queued.generation = new_generation ? generation_ + 1 : generation_;
+    if(!commands_.TryPush(std::move(queued)))
+        return false;
+    if(new_generation){
+        // Samples of earlier SimulateFrames still in flight are dropped.
+        generation_++;
+        render_objects.ghost_trail_->ghost_trail().Clear();
+    }
+    return true;
+}
+
+void InterpolationSimulation::Send(const SimulationCommand& command){
+    // Behind commands already waiting, to keep them in order.
+    if(!pending_commands_.empty() || !Post(command))
+        pending_commands_.push_back(command);
+}
+
+void InterpolationSimulation::PostPendingCommands(){
+    while(!pending_commands_.empty()){
+        if(!Post(pending_commands_.front()))
+            return;
+        pending_commands_.pop_front();
+    }
+}
+
+void InterpolationSimulation::SetRunning(bool value){
+    SimulationCommand command
+            = CreateCommand(SimulationCommandType::SET_RUNNING);
+    command.running = value;
+    Send(command);
+}
+
 void InterpolationSimulation::Reset(
         std::shared_ptr<InterpolationSimulationCreateParam> param){
-    SetRunning(false);
-    time_data_.simulation_length = param->simulation_length_s;
-    interpolation_data_.interpolation_method
-            = param->interpolation_data.interpolation_method;
+    TRACE_SCOPE("InterpolationSimulation::Reset");
+    SimulationCommand command
+            = CreateCommand(SimulationCommandType::RESET);
+    command.param = *param;
+    Send(command);
+}
 
-    interpolation_data_.position_begin = param->interpolation_data.position_begin;
-    interpolation_data_.position_end = param->interpolation_data.position_end;
-    interpolation_data_.euler_begin = param->interpolation_data.euler_begin;
-    interpolation_data_.euler_end = param->interpolation_data.euler_end;
+void InterpolationSimulation::SimulateFrames(
+        int count,
+        std::shared_ptr<InterpolationSimulationCreateParam> param){
+    TRACE_SCOPE("InterpolationSimulation::SimulateFrames");
+    SimulationCommand command
+            = CreateCommand(SimulationCommandType::SIMULATE_FRAMES);
+    command.param = *param;
+    command.frames_count = count;
+    command.frame_sampling_mode = frame_sampling_mode_;
+    command.adaptive_tolerance = adaptive_tolerance_;
+    Send(command);
+}
 
-    interpolation_data_.quaternion_begin
-            = param->interpolation_data.quaternion_begin;
-    interpolation_data_.quaternion_end
-            = param->interpolation_data.quaternion_end;
+void InterpolationSimulation::CancelSimulateFrames(){
+    SimulationCommand command
+            = CreateCommand(SimulationCommandType::CANCEL_SIMULATE_FRAMES);
+    Send(command);
+}
 
-    time_data_.total_time = 0.0f;
-    time_data_.current_time = 0.0f;
-    time_data_.time_since_last_update = 0.0f;
-    time_data_.last_time = glfwGetTime();
+bool InterpolationSimulation::ExportFrames(
+        int count,
+        std::shared_ptr<InterpolationSimulationCreateParam> param,
+        const std::string& path, TrajectoryFormat format){
+    if(*export_status_ == ExportStatus::RUNNING)
+        return false;
+    *export_status_ = ExportStatus::RUNNING;
+
+    std::shared_ptr<std::atomic<ExportStatus>> status = export_status_;
+    Interpolator interpolator(param->interpolation_data);
+    float simulation_length = param->simulation_length_s;
+    thread_pool_->Submit([status, interpolator, simulation_length,
+                          count, path, format](){
+        TrajectoryWriter writer;
+        bool success = writer.Open(path, format, simulation_length)
+                       && ExportTrajectory(interpolator, count,
+                                           simulation_length, writer);
+        success = writer.Close() && success;
+        *status = success ? ExportStatus::DONE : ExportStatus::FAILED;
+    });
+    return true;
+}
 
-    render_objects.render_object_euler_current_->moveTo(interpolation_data_.position_begin);
-    render_objects.render_object_euler_current_->rotateTo(interpolation_data_.euler_begin);
+void InterpolationSimulation::Update(){
+    TRACE_SCOPE("InterpolationSimulation::Update");
+    PostPendingCommands();
+    if(!runs_on_thread())
+        Tick();
+
+    if(published_state_.Update())
+        ApplyState(published_state_.read_buffer());
+    CommitSimulatedFrames();
+}
 
-    render_objects.render_object_quaternion_current_->moveTo(interpolation_data_.position_begin);
-    render_objects.render_object_quaternion_current_->rotateTo(interpolation_data_.euler_begin);
+const GhostTrail& InterpolationSimulation::ghost_trail(){
+    return render_objects.ghost_trail_->ghost_trail();
+}
 
-    render_objects.render_object_euler_current_->do_render(false);
-    render_objects.render_object_quaternion_current_->do_render(false);
+void InterpolationSimulation::SimulationLoop(){
+    TRACE_THREAD_NAME("Simulation");
+    while(!stop_thread_){
+        Tick();
 
-    for(auto& object : render_objects.render_objects_euler){
-        scene_->DeleteRenderObject(object.get());
+        double wait = scheduler_.step() - scheduler_.accumulator();
+        std::this_thread::sleep_for(std::chrono::duration<double>(wait));
     }
-    render_objects.render_objects_euler.clear();
-    for(auto& object : render_objects.render_objects_quaternion){
-        scene_->DeleteRenderObject(object.get());
-    }
-    render_objects.render_objects_quaternion.clear();
 }
 
-void InterpolationSimulation::Update(){
-    time_data_.current_time = glfwGetTime();
-    if(!running_){
+void InterpolationSimulation::Tick(){
+    TRACE_SCOPE("InterpolationSimulation::Tick");
+    SimulationCommand command;
+    while(commands_.TryPop(command))
+        Execute(command);
+    FrameSamples recycled;
+    while(recycled_samples_.TryPop(recycled))
+        frame_sampler_.Recycle(std::move(recycled));
+    if(frame_sampler_.IsDone())
+        PublishSimulatedFrames();
+
+    time_data_.current_time = clock_->Now();
+    if(!simulation_state_.running){
         time_data_.last_time = time_data_.current_time;
+        scheduler_.Reset(time_data_.current_time);
+        Publish();
         return;
     }
-    double elapsed = time_data_.current_time - time_data_.last_time;
-    time_data_.time_since_last_update += elapsed;
-    time_data_.total_time += elapsed;
+    int steps = scheduler_.Advance(time_data_.current_time);
     time_data_.last_time = time_data_.current_time;
-
-    if(time_data_.total_time > time_data_.simulation_length){
-        SetRunning(false);
+    time_data_.time_since_last_update = scheduler_.accumulator();
+    time_data_.alpha = scheduler_.alpha();
+    if(steps == 0){
+        Publish();
         return;
     }
-    if(time_data_.time_since_last_update >= time_data_.time_delta){
-        time_data_.time_since_last_update = 0.0f;
-        Update(elapsed);
+
+    for(int i = 0; i < steps; i++){
+        time_data_.total_time += time_data_.time_delta;
+        if(time_data_.total_time >= time_data_.simulation_length){
+            time_data_.total_time = time_data_.simulation_length;
+            time_data_.alpha = 1.0f;
+            TimedStep(time_data_.time_delta);
+            simulation_state_.running = false;
+            Publish();
+            return;
+        }
     }
+    TimedStep(time_data_.time_delta);
+    Publish();
 }
 
-void InterpolationSimulation::SimulateFrames(
-        int count,
-        std::shared_ptr<InterpolationSimulationCreateParam> param){
-    Reset(param);
-    SetRunning(false);
+void InterpolationSimulation::Execute(const SimulationCommand& command){
+    switch(command.type){
+        case SimulationCommandType::RESET:
+            ExecuteReset(command.param);
+            break;
+        case SimulationCommandType::SET_RUNNING:
+            simulation_state_.running = command.running;
+            if(command.running)
+                simulation_state_.render_current = true;
+            break;
+        case SimulationCommandType::SIMULATE_FRAMES:
+            ExecuteSimulateFrames(command);
+            break;
+        case SimulationCommandType::CANCEL_SIMULATE_FRAMES:
+            frame_sampler_.Cancel();
+            break;
+        case SimulationCommandType::SET_BLEND_WEIGHT:
+            if((size_t)command.blend_input < pose_blender_.input_count()){
+                pose_blender_.weight(command.blend_input,
+                                     command.blend_weight);
+            }
+            break;
+    }
+}
+
+void InterpolationSimulation::ExecuteReset(
+        const InterpolationSimulationCreateParam& param){
+    frame_sampler_.Cancel();
+    time_data_.simulation_length = param.simulation_length_s;
+    if(keyframe_track_ && keyframe_track_->duration() > 0.0f)
+        time_data_.simulation_length = keyframe_track_->duration();
+    float blend_duration = 0.0f;
+    for(const std::shared_ptr<KeyframeTrack>& track : blend_tracks_)
+        blend_duration = std::max(blend_duration, track->duration());
+    if(blend_duration > 0.0f)
+        time_data_.simulation_length = blend_duration;
+    interpolator_.data(param.interpolation_data);
+    const InterpolationData& interpolation_data = interpolator_.data();
+
+    time_data_.total_time = 0.0f;
+    time_data_.current_time = 0.0f;
+    time_data_.time_since_last_update = 0.0f;
+    time_data_.alpha = 0.0f;
+    time_data_.last_time = clock_->Now();
+    scheduler_.Reset(time_data_.last_time);
+
+    simulation_state_.running = false;
+    simulation_state_.render_current = false;
+    simulation_state_.euler_position = interpolation_data.position_begin;
+    simulation_state_.euler_angles = interpolation_data.euler_begin;
+    simulation_state_.quaternion_pose.position
+            = interpolation_data.position_begin;
+    simulation_state_.quaternion_pose.rotation
+            = interpolation_data.quaternion_begin;
+    if(skeleton_)
+        StepSkeleton(0.0f);
+}
+
+void InterpolationSimulation::ExecuteSimulateFrames(
+        const SimulationCommand& command){
+    TRACE_SCOPE("InterpolationSimulation::ExecuteSimulateFrames");
+    ExecuteReset(command.param);
     time_data_.total_time = time_data_.simulation_length;
-    for(int i = 0 ; i < count; i++){
-        float t = (float) i / (float) count;
-        glm::vec3 pos = InterpolatePosition(t);
-        glm::vec3 euler = InterpolateEulerAngles(t);
-        glm::vec3 quat_euler = InterpolateQuaternions(t);
+    frames_generation_ = command.generation;
+    simulate_frames_begin_ = std::chrono::steady_clock::now();
+    frame_sampler_.Start(interpolator_, command.frames_count,
+                         command.frame_sampling_mode,
+                         command.adaptive_tolerance);
+}
 
-        auto euler_object
-                = std::shared_ptr<ifx::RenderObject>(
-                        new ifx::RenderObject(
-                                *(render_objects.render_object_begin_.get())));
-        euler_object->id(ObjectID(-1));
-        euler_object->moveTo(pos);
-        euler_object->rotateTo(euler);
-        auto quat_object
-                = std::shared_ptr<ifx::RenderObject>(
-                        new ifx::RenderObject(
-                                *(render_objects.render_object_begin_.get())));
-        quat_object->id(ObjectID(-2));
-        quat_object->moveTo(pos);
-        quat_object->rotateTo(quat_euler);
+void InterpolationSimulation::TimedStep(double time_elapsed){
+    std::chrono::steady_clock::time_point begin
+            = std::chrono::steady_clock::now();
+    Step(time_elapsed);
+    step_latency_.Add(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - begin).count());
+}
 
-        render_objects.render_objects_euler.push_back(euler_object);
-        render_objects.render_objects_quaternion.push_back(quat_object);
-        scene_->AddRenderObject(euler_object);
-        scene_->AddRenderObject(quat_object);
+void InterpolationSimulation::Step(double time_elapsed){
+    // Rendered between the previous and the current step.
+    float time = time_data_.total_time
+                 - (float)time_elapsed * (1.0f - time_data_.alpha);
+    if(time < 0.0f)
+        time = 0.0f;
+
+    float t = Fraction(time);
+    if(skeleton_)
+        StepSkeleton(t);
+
+    if(!blend_tracks_.empty()){
+        StepBlend(t);
+        return;
     }
+    if(keyframe_track_ && keyframe_track_->size() > 0){
+        StepKeyframeTrack(time);
+        return;
+    }
+
+    Pose pose = interpolator_.InterpolatePose(t);
+    simulation_state_.euler_position = pose.position;
+    simulation_state_.euler_angles = interpolator_.InterpolateEulerAngles(t);
+    simulation_state_.quaternion_pose = pose;
 }
 
-void InterpolationSimulation::Update(double time_elapsed){
-    float t = time_data_.total_time / time_data_.simulation_length;
+float InterpolationSimulation::Fraction(float time){
+    // A zero length, e.g. a single key track, is over right away.
+    if(!(time_data_.simulation_length > 0.0f))
+        return 1.0f;
+    return std::min(time / time_data_.simulation_length, 1.0f);
+}
 
-    glm::vec3 pos = InterpolatePosition(t);
-    render_objects.render_object_euler_current_->moveTo(pos);
-    render_objects.render_object_quaternion_current_->moveTo(pos);
+void InterpolationSimulation::StepKeyframeTrack(float time){
+    Pose pose;
+    keyframe_track_->Evaluate(keyframe_track_->start_time() + time,
+                              pose.position, pose.rotation);
 
-    render_objects.render_object_euler_current_->rotateTo(
-            InterpolateEulerAngles(t));
-    render_objects.render_object_quaternion_current_->rotateTo(
-            InterpolateQuaternions(t));
+    simulation_state_.euler_position = pose.position;
+    simulation_state_.euler_angles = QuaternionToEulerDegrees(pose.rotation);
+    simulation_state_.quaternion_pose = pose;
 }
 
-glm::vec3 InterpolationSimulation::InterpolatePosition(float t){
-    glm::vec3 direction = interpolation_data_.position_end -
-                          interpolation_data_.position_begin;
-    glm::vec3 interpolated_position
-            = interpolation_data_.position_begin + direction * t;
-
-    return interpolated_position;
+void InterpolationSimulation::StepSkeleton(float t){
+    skeleton_->Evaluate(t * skeleton_->duration(), skeleton_local_,
+                        simulation_state_.skeleton_pose);
 }
 
-glm::vec3 InterpolationSimulation::InterpolateEulerAngles(float t){
-    glm::vec3 diff = interpolation_data_.euler_end - interpolation_data_
-            .euler_begin;
+void InterpolationSimulation::StepBlend(float t){
+    for(size_t i = 0; i < blend_tracks_.size(); i++){
+        const KeyframeTrack& track = *blend_tracks_[i];
+        Pose& pose = pose_blender_.input(i)[0];
+        track.Evaluate(track.start_time() + t * track.duration(),
+                       pose.position, pose.rotation);
+    }
+    Pose pose;
+    pose_blender_.Blend(&pose);
+
+    simulation_state_.euler_position = pose.position;
+    simulation_state_.euler_angles = QuaternionToEulerDegrees(pose.rotation);
+    simulation_state_.quaternion_pose = pose;
+}
 
-    glm::vec3 interpolated_angles = interpolation_data_ .euler_begin + diff * t;
+void InterpolationSimulation::PublishSimulatedFrames(){
+    SimulatedFrames frames;
+    frames.generation = frames_generation_;
+    if(!frame_sampler_.TakeSamples(frames.samples))
+        return;
+    simulate_frames_latency_.Add(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - simulate_frames_begin_).count());
+    // The queue only fills up when the render thread stalls, the samples
+    // are dropped like a cancelled job then.
+    simulated_frames_.TryPush(std::move(frames));
+}
 
-    return interpolated_angles;
+void InterpolationSimulation::Publish(){
+    simulation_state_.total_time = time_data_.total_time;
+    simulation_state_.simulation_length = time_data_.simulation_length;
+    simulation_state_.simulating_frames = frame_sampler_.IsRunning();
+    simulation_state_.simulate_frames_progress = frame_sampler_.progress();
+    simulation_state_.step_latency = step_latency_.Percentiles();
+    simulation_state_.simulate_frames_latency
+            = simulate_frames_latency_.Percentiles();
+    simulation_state_.steps_taken = scheduler_.steps_taken();
+    simulation_state_.steps_dropped = scheduler_.steps_dropped();
+
+    published_state_.write_buffer() = simulation_state_;
+    published_state_.Publish();
 }
 
-glm::vec3 InterpolationSimulation::InterpolateQuaternions(float t){
-    glm::quat q;
-    if(interpolation_data_.interpolation_method == InterpolationMethod::LERP){
-        q = glm::lerp(interpolation_data_.quaternion_begin,
-                      interpolation_data_.quaternion_end, t);
+void InterpolationSimulation::ApplyState(const SimulationState& state){
+    if(state.running != state_.running){
+        ifx::Simulation::SetRunning(state.running);
+        render_objects.render_object_begin_->do_render(!state.running);
+        render_objects.render_object_end_->do_render(!state.running);
+    }
+    if(state.render_current != state_.render_current){
+        render_objects.render_object_euler_current_->do_render(
+                state.render_current);
+        render_objects.render_object_quaternion_current_->do_render(
+                state.render_current);
+        render_objects.skeleton_joints_->do_render(state.render_current);
     }
-    else if(interpolation_data_.interpolation_method ==
-            InterpolationMethod::SLERP){
-        q = glm::slerp(interpolation_data_.quaternion_begin,
-                       interpolation_data_.quaternion_end, t);
+
+    render_objects.render_object_euler_current_->moveTo(state.euler_position);
+    render_objects.render_object_euler_current_->rotateTo(state.euler_angles);
+    render_objects.render_object_quaternion_current_->pose(
+            state.quaternion_pose);
+    render_objects.skeleton_joints_->ghost_trail().Build(state.skeleton_pose);
+    if(euler_diagnostics_){
+        quaternion_euler_ = QuaternionToEulerDegrees(
+                state.quaternion_pose.rotation);
     }
-    q = glm::normalize(q);
-    glm::vec3 euler = glm::degrees(glm::eulerAngles(q));
+    state_ = state;
+}
 
-    return euler;
+void InterpolationSimulation::CommitSimulatedFrames(){
+    SimulatedFrames frames;
+    while(simulated_frames_.TryPop(frames)){
+        if(frames.generation == generation_)
+            render_objects.ghost_trail_->ghost_trail().Build(frames.samples);
+        recycled_samples_.TryPush(std::move(frames.samples));
+    }
 }
 
 void InterpolationSimulation::InitScene(
         std::shared_ptr<ifx::Scene> scene,
-        std::shared_ptr<ifx::RenderObject> render_object){
+        std::shared_ptr<ifx::RenderObject> render_object,
+        std::shared_ptr<ifx::Model> model){
     render_objects.render_object_begin_ = std::shared_ptr<ifx::RenderObject>(
             new ifx::RenderObject(*(render_object.get())));
     render_objects.render_object_end_ = std::shared_ptr<ifx::RenderObject>(
@@ -203,15 +513,31 @@ void InterpolationSimulation::InitScene(
             = std::shared_ptr<ifx::RenderObject>(
             new ifx::RenderObject(*(render_object.get())));
     render_objects.render_object_euler_current_->id(ObjectID(-1));
+    render_objects.render_object_euler_current_->do_render(false);
+
     render_objects.render_object_quaternion_current_
-            = std::shared_ptr<ifx::RenderObject>(
-            new ifx::RenderObject(*(render_object.get())));
-    render_objects.render_object_quaternion_current_->id(ObjectID(-2));
+            = std::make_shared<PoseRenderObject>(*render_object);
+    render_objects.render_object_quaternion_current_->id(ObjectID(-1));
+    render_objects.render_object_quaternion_current_->do_render(false);
+
+    render_objects.skeleton_joints_
+            = std::make_shared<GhostTrailRenderObject>(*render_object,
+                                                       model, scene);
+    render_objects.skeleton_joints_->do_render(false);
+    render_objects.ghost_trail_
+            = std::make_shared<GhostTrailRenderObject>(*render_object,
+                                                       model, scene);
+
+    // Matches the scene above, ApplyState only applies changes.
+    state_.running = false;
+    state_.render_current = false;
 
     scene->AddRenderObject(render_objects.render_object_begin_);
     scene->AddRenderObject(render_objects.render_object_end_);
     scene->AddRenderObject(render_objects.render_object_euler_current_);
     scene->AddRenderObject(render_objects.render_object_quaternion_current_);
+    scene->AddRenderObject(render_objects.skeleton_joints_);
+    scene->AddRenderObject(render_objects.ghost_trail_);
 }
 
 void InterpolationSimulation::InitParameters(){
@@ -236,5 +562,9 @@ void InterpolationSimulation::InitParameters(){
     param->interpolation_data.quaternion_end
             = glm::normalize(param->interpolation_data.quaternion_end);
 
-    Reset(param);
+    // Applied right away, the GUI reads the initial parameters back.
+    ExecuteReset(*param);
+    Publish();
+    if(published_state_.Update())
+        ApplyState(published_state_.read_buffer());
 }
@@ -2,30 +2,66 @@
 #include <factory/render_object_factory.h>
 #include <rendering/renderer.h>
 
+#include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 #include <movement_interpolation/gui/movement_interpolation_gui.h>
 #include <movement_interpolation/interpolation_simulation.h>
+#include <movement_interpolation/core/keyframe_file.h>
 #include <factory/texture_factory.h>
 #include <factory/program_factory.h>
 #include <model_loader/model_loader.h>
 
 void InitScene(ifx::GameLoop& game_loop);
-void InitSimulation(ifx::GameLoop& game_loop);
+void InitSimulation(ifx::GameLoop& game_loop,
+                    const std::vector<std::string>& keyframe_paths);
+
+std::shared_ptr<SkeletonTrack> CreateSkeleton(
+        const KeyframeFile& keyframe_file);
 
 std::shared_ptr<ifx::Model> CreateAxisModel();
-std::shared_ptr<ifx::RenderObject> CreateAxis();
+std::shared_ptr<ifx::RenderObject> CreateAxis(
+        std::shared_ptr<ifx::Model> model);
+
+const float kAxisScale = 0.4f;
 
 void InitScene(ifx::GameLoop& game_loop){
     game_loop.renderer()->scene()->AddRenderObject(
             ifx::RenderObjectFactory().CreateQuad());
 }
 
-void InitSimulation(ifx::GameLoop& game_loop){
+void InitSimulation(ifx::GameLoop& game_loop,
+                    const std::vector<std::string>& keyframe_paths){
+    auto axis_model = CreateAxisModel();
     auto simulation = std::shared_ptr<InterpolationSimulation>(
             new InterpolationSimulation(
                     game_loop.renderer()->scene(),
                     game_loop.renderer(),
-                    CreateAxis()));
+                    CreateAxis(axis_model),
+                    axis_model));
+    std::vector<std::shared_ptr<KeyframeTrack>> blend_tracks;
+    for(size_t i = 0; i < keyframe_paths.size(); i++){
+        // The track keeps the file mapped after keyframe_file is gone.
+        KeyframeFile keyframe_file;
+        if(!keyframe_file.Open(keyframe_paths[i])){
+            std::cout << keyframe_file.error() << std::endl;
+            continue;
+        }
+        std::shared_ptr<KeyframeTrack> track = keyframe_file.Track(0);
+        if(!track){
+            std::cout << keyframe_file.error() << std::endl;
+            continue;
+        }
+        if(i == 0){
+            simulation->SetKeyframeTrack(track);
+            if(keyframe_file.track_count() > 1)
+                simulation->SetSkeleton(CreateSkeleton(keyframe_file));
+        }
+        blend_tracks.push_back(track);
+    }
+    if(blend_tracks.size() > 1)
+        simulation->SetBlendTracks(blend_tracks);
     auto gui = std::unique_ptr<MovementInterpolationGUI>(
             new MovementInterpolationGUI(
                     game_loop.renderer()->window()->getHandle(),
@@ -35,28 +71,63 @@ void InitSimulation(ifx::GameLoop& game_loop){
     game_loop.AddSimulation(simulation);
 }
 
-std::shared_ptr<ifx::RenderObject> CreateAxis(){
-    std::shared_ptr<Program> program = ifx::ProgramFactory().LoadMainProgram();
+/**
+ * Plays the tracks back as the local poses of the joints.
+ */
+std::shared_ptr<SkeletonTrack> CreateSkeleton(
+        const KeyframeFile& keyframe_file){
+    auto skeleton = std::make_shared<Skeleton>();
+    std::vector<std::shared_ptr<KeyframeTrack>> tracks;
+    for(size_t i = 0; i < keyframe_file.track_count(); i++){
+        if(skeleton->AddJoint(keyframe_file.track_name(i),
+                              keyframe_file.track_parent(i)) < 0){
+            std::cout << "Joint " << keyframe_file.track_name(i)
+                      << " comes before its parent" << std::endl;
+            return nullptr;
+        }
+        std::shared_ptr<KeyframeTrack> track = keyframe_file.Track(i);
+        if(!track){
+            std::cout << keyframe_file.error() << std::endl;
+            return nullptr;
+        }
+        tracks.push_back(track);
+    }
+    auto skeleton_track = std::make_shared<SkeletonTrack>();
+    skeleton_track->Set(skeleton, tracks);
+    return skeleton_track;
+}
+
+std::shared_ptr<ifx::Model> CreateAxisModel(){
     std::string path
             = ifx::Resources::GetInstance().GetResourcePath(
                     "axis-obj/axis.obj", ifx::ResourceType::MODEL);
-    auto model = ifx::ModelLoader(path).loadModel();
+    return ifx::ModelLoader(path).loadModel();
+}
 
+std::shared_ptr<ifx::RenderObject> CreateAxis(
+        std::shared_ptr<ifx::Model> model){
+    std::shared_ptr<Program> program = ifx::ProgramFactory().LoadMainProgram();
     auto render_object
             = std::shared_ptr<ifx::RenderObject>(
                     new ifx::RenderObject(ObjectID(0),
                                           model));
     render_object->addProgram(program);
-    render_object->scale(0.4);
+    render_object->scale(kAxisScale);
     return render_object;
 }
 
-int main() {
+/**
+ * Optional arguments: keyframe files. The first track of the first file
+ * is played back, a file with more tracks is also played back as a
+ * skeleton. With several files their first tracks are blended.
+ */
+int main(int argc, char** argv) {
     ifx::GameLoop game_loop(
             std::move(ifx::RenderObjectFactory().CreateRenderer()));
 
     InitScene(game_loop);
-    InitSimulation(game_loop);
+    InitSimulation(game_loop,
+                   std::vector<std::string>(argv + 1, argv + argc));
 
     game_loop.Start();
 }
@@ -0,0 +1,175 @@
+#include "movement_interpolation/rendering/ghost_trail_render_object.h"
+
+#include <rendering/scene/scene.h>
+#include <rendering/camera/camera.h>
+#include <model/model.h>
+#include <model/mesh.h>
+#include <shaders/program.h>
+#include <shaders/shaders/vertex_shader.h>
+#include <shaders/shaders/fragment_shader.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstddef>
+
+namespace {
+
+const char* kVertexShader = R"(
+#version 330 core
+// Vertex layout of the engine's meshes.
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 normal;
+in vec4 instance_position;
+in vec4 instance_rotation;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec3 world_normal;
+
+vec3 Rotate(vec4 q, vec3 v){
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main(){
+    vec3 local = (model * vec4(position, 1.0)).xyz;
+    vec3 world = Rotate(instance_rotation, local) + instance_position.xyz;
+    gl_Position = projection * view * vec4(world, 1.0);
+    world_normal = Rotate(instance_rotation, mat3(model) * normal);
+}
+)";
+
+const char* kFragmentShader = R"(
+#version 330 core
+in vec3 world_normal;
+out vec4 color;
+
+const vec3 kLightDirection = vec3(0.267, 0.802, 0.535);
+const vec3 kColor = vec3(0.8, 0.8, 0.8);
+
+void main(){
+    float diffuse = max(dot(normalize(world_normal), kLightDirection), 0.0);
+    color = vec4(kColor * (0.3 + 0.7 * diffuse), 1.0);
+}
+)";
+
+}
+
+GhostTrailRenderObject::GhostTrailRenderObject(
+        const ifx::RenderObject& render_object,
+        std::shared_ptr<ifx::Model> model,
+        std::shared_ptr<ifx::Scene> scene) :
+        ifx::RenderObject(render_object),
+        model_(model),
+        scene_(scene),
+        instance_vbo_(0),
+        instance_capacity_bytes_(0),
+        uploaded_revision_(0),
+        bound_program_(0),
+        instance_position_location_(-1),
+        instance_rotation_location_(-1){
+    // The base matrix only scales, the instances place it.
+    moveTo(glm::vec3(0, 0, 0));
+    rotateTo(glm::vec3(0, 0, 0));
+    addProgram(CreateProgram());
+}
+
+GhostTrailRenderObject::~GhostTrailRenderObject(){
+    if(instance_vbo_ != 0)
+        glDeleteBuffers(1, &instance_vbo_);
+}
+
+void GhostTrailRenderObject::render(const Program& program){
+    if(!do_render() || ghost_trail_.size() == 0)
+        return;
+    if(program.getID() != bound_program_ &&
+       !BindInstanceAttributes(program.getID()))
+        return;
+
+    GLint last_vao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vao);
+
+    if(uploaded_revision_ != ghost_trail_.revision())
+        UploadInstances();
+
+    auto camera = scene_->camera();
+    program.use();
+    glUniformMatrix4fv(model_location_, 1, GL_FALSE,
+                       glm::value_ptr(ModelMatrix));
+    glUniformMatrix4fv(view_location_, 1, GL_FALSE,
+                       glm::value_ptr(camera->getViewMatrix()));
+    glUniformMatrix4fv(projection_location_, 1, GL_FALSE,
+                       glm::value_ptr(camera->getProjectionMatrix()));
+    for(ifx::Mesh* mesh : model_->getMeshes()){
+        mesh->vao()->bind();
+        glDrawElementsInstanced(GL_TRIANGLES,
+                                (GLsizei)mesh->indices().size(),
+                                GL_UNSIGNED_INT, 0,
+                                (GLsizei)ghost_trail_.size());
+    }
+
+    glBindVertexArray(last_vao);
+}
+
+std::shared_ptr<Program> GhostTrailRenderObject::CreateProgram(){
+    VertexShader vertex_shader(kVertexShader);
+    FragmentShader fragment_shader(kFragmentShader);
+    vertex_shader.compile();
+    fragment_shader.compile();
+    return std::make_shared<Program>(vertex_shader, fragment_shader);
+}
+
+bool GhostTrailRenderObject::BindInstanceAttributes(GLuint program){
+    GLint position_location
+            = glGetAttribLocation(program, "instance_position");
+    GLint rotation_location
+            = glGetAttribLocation(program, "instance_rotation");
+    if(position_location < 0 || rotation_location < 0)
+        return false;
+
+    GLint last_vao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vao);
+    if(instance_vbo_ == 0)
+        glGenBuffers(1, &instance_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+    for(ifx::Mesh* mesh : model_->getMeshes()){
+        mesh->vao()->bind();
+        // Set up for an earlier program at other locations.
+        if(instance_position_location_ >= 0){
+            glDisableVertexAttribArray(instance_position_location_);
+            glDisableVertexAttribArray(instance_rotation_location_);
+        }
+        glVertexAttribPointer(position_location, 4, GL_FLOAT, GL_FALSE,
+                              sizeof(GhostInstance),
+                              (GLvoid*)offsetof(GhostInstance, position));
+        glEnableVertexAttribArray(position_location);
+        glVertexAttribDivisor(position_location, 1);
+        glVertexAttribPointer(rotation_location, 4, GL_FLOAT, GL_FALSE,
+                              sizeof(GhostInstance),
+                              (GLvoid*)offsetof(GhostInstance, rotation));
+        glEnableVertexAttribArray(rotation_location);
+        glVertexAttribDivisor(rotation_location, 1);
+    }
+    glBindVertexArray(last_vao);
+
+    bound_program_ = program;
+    instance_position_location_ = position_location;
+    instance_rotation_location_ = rotation_location;
+    model_location_ = glGetUniformLocation(program, "model");
+    view_location_ = glGetUniformLocation(program, "view");
+    projection_location_ = glGetUniformLocation(program, "projection");
+    return true;
+}
+
+void GhostTrailRenderObject::UploadInstances(){
+    size_t size_bytes = ghost_trail_.size_bytes();
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+    if(size_bytes > instance_capacity_bytes_){
+        instance_capacity_bytes_ = ghost_trail_.capacity_bytes();
+        glBufferData(GL_ARRAY_BUFFER, instance_capacity_bytes_, NULL,
+                     GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size_bytes, ghost_trail_.data());
+    uploaded_revision_ = ghost_trail_.revision();
+}
@@ -0,0 +1,17 @@
+#include "movement_interpolation/rendering/pose_render_object.h"
+
+PoseRenderObject::PoseRenderObject(const ifx::RenderObject& render_object) :
+        ifx::RenderObject(render_object){
+    pose_.position = glm::vec3(0, 0, 0);
+    pose_.rotation = glm::quat(1, 0, 0, 0);
+    // The base matrix only scales, the pose places it.
+    moveTo(glm::vec3(0, 0, 0));
+    rotateTo(glm::vec3(0, 0, 0));
+}
+
+PoseRenderObject::~PoseRenderObject(){}
+
+void PoseRenderObject::update(){
+    ifx::RenderObject::update();
+    ModelMatrix = PoseToModelMatrix(pose_) * ModelMatrix;
+}
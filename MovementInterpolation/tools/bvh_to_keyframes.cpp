@@ -0,0 +1,29 @@
+#include "movement_interpolation/core/bvh_loader.h"
+#include "movement_interpolation/core/keyframe_file.h"
+
+#include <cstdio>
+
+/**
+ * Converts a BVH motion capture file to a keyframe file.
+ *
+ * Usage: bvh_to_keyframes input.bvh output.mikf
+ */
+int main(int argc, char** argv){
+    if(argc != 3){
+        std::printf("Usage: %s input.bvh output.mikf\n", argv[0]);
+        return 1;
+    }
+    std::vector<NamedKeyframeTrack> tracks;
+    std::string error;
+    if(!LoadBvh(argv[1], tracks, error)){
+        std::printf("%s\n", error.c_str());
+        return 1;
+    }
+    if(!KeyframeFile::Write(argv[2], tracks)){
+        std::printf("Could not write %s\n", argv[2]);
+        return 1;
+    }
+    size_t keys = tracks.empty() ? 0 : tracks.front().track->size();
+    std::printf("%zu joints, %zu keys per joint\n", tracks.size(), keys);
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "movement_interpolation/core/compressed_keyframe_track.h"
+#include "movement_interpolation/core/keyframe_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * Compresses every track of a keyframe file and reports the memory saved
+ * and the largest error per track.
+ *
+ * Usage: compress_keyframes input.mikf [--low]
+ */
+int main(int argc, char** argv){
+    if(argc < 2 || argc > 3
+       || (argc == 3 && std::strcmp(argv[2], "--low") != 0)){
+        std::printf("Usage: %s input.mikf [--low]\n", argv[0]);
+        return 1;
+    }
+    KeyframeCompression compression = argc == 3 ? KeyframeCompression::LOW
+                                                 : KeyframeCompression::HIGH;
+    KeyframeFile keyframe_file;
+    if(!keyframe_file.Open(argv[1])){
+        std::printf("%s\n", keyframe_file.error().c_str());
+        return 1;
+    }
+
+    size_t source_bytes = 0;
+    size_t compressed_bytes = 0;
+    CompressionError max_error = CompressionError();
+    std::printf("%-32s %8s %10s %10s %10s %10s\n", "track", "keys", "bytes",
+                "time", "position", "angle");
+    for(size_t i = 0; i < keyframe_file.track_count(); i++){
+        std::shared_ptr<KeyframeTrack> track = keyframe_file.Track(i);
+        if(!track){
+            std::printf("%s\n", keyframe_file.error().c_str());
+            return 1;
+        }
+        CompressedKeyframeTrack compressed;
+        compressed.Compress(*track, compression);
+        CompressionError error = compressed.MeasureError(*track);
+
+        source_bytes += track->size() * sizeof(Keyframe);
+        compressed_bytes += compressed.size_bytes();
+        max_error.time = std::max(max_error.time, error.time);
+        max_error.position = std::max(max_error.position, error.position);
+        max_error.angle_degrees = std::max(max_error.angle_degrees,
+                                           error.angle_degrees);
+        std::printf("%-32s %8zu %10zu %10g %10g %10g\n",
+                    keyframe_file.track_name(i).c_str(), track->size(),
+                    compressed.size_bytes(), error.time, error.position,
+                    error.angle_degrees);
+    }
+
+    double ratio = compressed_bytes > 0
+                   ? (double)source_bytes / (double)compressed_bytes : 0.0;
+    std::printf("%zu -> %zu bytes, %.2fx smaller\n", source_bytes,
+                compressed_bytes, ratio);
+    std::printf("Max error: time %g, position %g, angle %g degrees\n",
+                max_error.time, max_error.position, max_error.angle_degrees);
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include "movement_interpolation/core/batch_job.h"
+#include "movement_interpolation/core/thread_pool.h"
+#include "movement_interpolation/core/trajectory_writer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Jobs read, run and written at a time, bounds the memory of a sweep.
+const size_t kJobsPerWave = 16384;
+// Frames kept per wave with --poses, two waves are in memory at a time.
+// A single job may have this many.
+const unsigned long long kFramesPerWave = kMaxBatchJobFrames;
+const size_t kJobsPerTask = 64;
+
+/**
+ * Jobs of the sweep run together. The storage is reused by later waves.
+ */
+struct Wave {
+    std::vector<BatchJob> jobs;
+    std::vector<DivergenceStats> stats;
+    // Only kept when the poses are written.
+    std::vector<FrameSamples> samples;
+};
+
+void PrintUsage(const char* program){
+    std::printf("Usage: %s jobs.txt results.csv [--poses poses.mitr] "
+                "[--threads n]\n", program);
+}
+
+/**
+ * Reads up to kJobsPerWave jobs into wave, with write_poses also no more
+ * than kFramesPerWave frames. A job that does not fit is moved to
+ * carried and starts the next wave.
+ */
+bool ReadWave(std::istream& input, bool write_poses, Wave& wave,
+              std::vector<BatchJob>& carried, size_t& line_number,
+              std::string& error){
+    wave.jobs.clear();
+    if(!write_poses)
+        return ReadBatchJobs(input, kJobsPerWave, wave.jobs, line_number,
+                             error);
+    unsigned long long frames = 0;
+    wave.jobs.swap(carried);
+    if(!wave.jobs.empty())
+        frames = (unsigned long long)wave.jobs[0].frames_count;
+    while(wave.jobs.size() < kJobsPerWave){
+        if(!ReadBatchJobs(input, 1, carried, line_number, error))
+            return false;
+        if(carried.empty())
+            break;
+        frames += (unsigned long long)carried[0].frames_count;
+        if(frames > kFramesPerWave)
+            break;
+        wave.jobs.push_back(carried[0]);
+        carried.clear();
+    }
+    return true;
+}
+
+void SampleWave(ThreadPool& thread_pool, bool write_poses, Wave& wave){
+    wave.stats.resize(wave.jobs.size());
+    if(write_poses)
+        wave.samples.resize(wave.jobs.size());
+    thread_pool.ParallelFor(wave.jobs.size(), kJobsPerTask,
+                            [&](size_t begin, size_t end){
+        FrameSamples scratch;
+        for(size_t i = begin; i < end; i++){
+            wave.stats[i] = RunBatchJob(
+                    wave.jobs[i], write_poses ? wave.samples[i] : scratch);
+        }
+    });
+}
+
+bool WritePoses(const BatchJob& job, const FrameSamples& samples,
+                TrajectoryWriter& writer){
+    TrajectorySample sample;
+    for(size_t i = 0; i < samples.size(); i++){
+        sample.time = (float)i / (float)job.frames_count
+                      * job.param.simulation_length_s;
+        sample.position = samples.positions[i];
+        sample.euler_angles = samples.euler_angles[i];
+        sample.quaternion = samples.quaternions[i];
+        if(!writer.Write(sample))
+            return false;
+    }
+    return true;
+}
+
+}
+
+/**
+ * Runs a parameter sweep without a window or GPU. Every job of the job
+ * file, see ParseBatchJob, is sampled like SimulateFrames on all cores
+ * and its Euler against quaternion divergence is written to a CSV file,
+ * in job order. With --poses the sampled frames of all jobs are streamed
+ * to one binary trajectory, first_sample locates the frames of a job.
+ * Jobs run in waves, the next wave is sampled while the previous one is
+ * written.
+ */
+int main(int argc, char** argv){
+    if(argc < 3){
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    std::string jobs_path = argv[1];
+    std::string results_path = argv[2];
+    std::string poses_path;
+    unsigned int threads = 0;
+    for(int i = 3; i < argc; i++){
+        if(i + 1 < argc && std::strcmp(argv[i], "--poses") == 0)
+            poses_path = argv[++i];
+        else if(i + 1 < argc && std::strcmp(argv[i], "--threads") == 0)
+            threads = (unsigned int)std::atoi(argv[++i]);
+        else{
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::ifstream input(jobs_path);
+    if(!input){
+        std::printf("Could not open %s\n", jobs_path.c_str());
+        return 1;
+    }
+    FILE* results = std::fopen(results_path.c_str(), "w");
+    if(!results){
+        std::printf("Could not write %s\n", results_path.c_str());
+        return 1;
+    }
+    std::fprintf(results, "job,frames,first_sample,mean_degrees,"
+                          "rms_degrees,max_degrees,max_time\n");
+    TrajectoryWriter poses;
+    bool write_poses = !poses_path.empty();
+    if(write_poses && !poses.Open(poses_path, TrajectoryFormat::BINARY, 0)){
+        std::printf("Could not write %s\n", poses_path.c_str());
+        std::fclose(results);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool thread_pool(threads);
+    // The next wave is sampled while this thread writes the previous one.
+    Wave waves[2];
+    std::vector<BatchJob> carried;
+    size_t line_number = 0;
+    size_t job_count = 0;
+    unsigned long long sample_count = 0;
+    bool success = true;
+    std::string error;
+    if(!ReadWave(input, write_poses, waves[0], carried, line_number,
+                 error)){
+        std::printf("%s: %s\n", jobs_path.c_str(), error.c_str());
+        success = false;
+    }
+    else
+        SampleWave(thread_pool, write_poses, waves[0]);
+    for(int current = 0; success && !waves[current].jobs.empty();
+        current = 1 - current){
+        Wave& wave = waves[current];
+        Wave& next = waves[1 - current];
+        next.jobs.clear();
+        if(!ReadWave(input, write_poses, next, carried, line_number,
+                     error)){
+            std::printf("%s: %s\n", jobs_path.c_str(), error.c_str());
+            success = false;
+        }
+        std::thread sampler;
+        if(!next.jobs.empty()){
+            sampler = std::thread([&](){
+                SampleWave(thread_pool, write_poses, next);
+            });
+        }
+
+        for(size_t i = 0; i < wave.jobs.size() && success; i++){
+            const DivergenceStats& job_stats = wave.stats[i];
+            std::fprintf(results, "%zu,%d,%llu,%.6g,%.6g,%.6g,%.6g\n",
+                         job_count + i, wave.jobs[i].frames_count,
+                         sample_count, job_stats.mean_degrees,
+                         job_stats.rms_degrees, job_stats.max_degrees,
+                         job_stats.max_time);
+            sample_count += (unsigned long long)wave.jobs[i].frames_count;
+            if(write_poses)
+                success = WritePoses(wave.jobs[i], wave.samples[i], poses);
+        }
+        job_count += wave.jobs.size();
+        if(sampler.joinable())
+            sampler.join();
+    }
+
+    if(write_poses && !poses.Close())
+        success = false;
+    if(std::fclose(results) != 0)
+        success = false;
+    if(!success){
+        std::printf("Sweep failed after %zu jobs\n", job_count);
+        return 1;
+    }
+    std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+    std::printf("%zu jobs, %llu frames in %.2f s on %u threads\n",
+                job_count, sample_count, elapsed.count(), thread_pool.size());
+    return 0;
+}
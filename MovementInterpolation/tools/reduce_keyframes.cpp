@@ -0,0 +1,126 @@
+#include "movement_interpolation/core/keyframe_file.h"
+#include "movement_interpolation/core/keyframe_reduction.h"
+#include "movement_interpolation/core/thread_pool.h"
+#include "movement_interpolation/core/trajectory_reader.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+bool HasExtension(const std::string& path, const std::string& extension){
+    return path.size() >= extension.size()
+           && path.compare(path.size() - extension.size(),
+                           extension.size(), extension) == 0;
+}
+
+/**
+ * Quaternion path of an exported trajectory as a single SLERP track.
+ */
+bool LoadTrajectoryTrack(const std::string& path,
+                         std::vector<NamedKeyframeTrack>& tracks){
+    std::vector<TrajectorySample> samples;
+    float simulation_length;
+    std::string error;
+    if(!ReadTrajectory(path, samples, simulation_length, error)){
+        std::printf("%s\n", error.c_str());
+        return false;
+    }
+    NamedKeyframeTrack named;
+    named.name = "trajectory";
+    named.parent = -1;
+    named.track = std::make_shared<KeyframeTrack>();
+    named.track->Reserve(samples.size());
+    for(const TrajectorySample& sample : samples){
+        Keyframe key;
+        key.time = sample.time;
+        key.position = sample.position;
+        key.rotation = sample.quaternion;
+        named.track->AddKey(key);
+    }
+    tracks.push_back(named);
+    return true;
+}
+
+bool LoadKeyframeTracks(const std::string& path,
+                        std::vector<NamedKeyframeTrack>& tracks){
+    KeyframeFile keyframe_file;
+    if(!keyframe_file.Open(path)){
+        std::printf("%s\n", keyframe_file.error().c_str());
+        return false;
+    }
+    for(size_t i = 0; i < keyframe_file.track_count(); i++){
+        NamedKeyframeTrack named;
+        named.name = keyframe_file.track_name(i);
+        named.parent = keyframe_file.track_parent(i);
+        named.track = keyframe_file.Track(i);
+        if(!named.track){
+            std::printf("%s\n", keyframe_file.error().c_str());
+            return false;
+        }
+        tracks.push_back(named);
+    }
+    return true;
+}
+
+void PrintUsage(const char* program){
+    std::printf("Usage: %s input.mikf|input.mitr output.mikf "
+                "[--position distance] [--angle degrees] [--threads n]\n",
+                program);
+}
+
+}
+
+/**
+ * Removes keys while the reconstruction stays within tolerance. Input is
+ * a keyframe file, e.g. a converted capture, or a binary trajectory
+ * exported from SimulateFrames. Tracks are reduced in parallel.
+ */
+int main(int argc, char** argv){
+    if(argc < 3){
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    std::string input = argv[1];
+    std::string output = argv[2];
+    ReductionTolerance tolerance;
+    unsigned int threads = 0;
+    for(int i = 3; i < argc; i++){
+        if(i + 1 < argc && std::strcmp(argv[i], "--position") == 0)
+            tolerance.position = (float)std::atof(argv[++i]);
+        else if(i + 1 < argc && std::strcmp(argv[i], "--angle") == 0)
+            tolerance.angle_degrees = (float)std::atof(argv[++i]);
+        else if(i + 1 < argc && std::strcmp(argv[i], "--threads") == 0)
+            threads = (unsigned int)std::atoi(argv[++i]);
+        else{
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<NamedKeyframeTrack> tracks;
+    bool loaded = HasExtension(input, ".mitr")
+                  ? LoadTrajectoryTrack(input, tracks)
+                  : LoadKeyframeTracks(input, tracks);
+    if(!loaded)
+        return 1;
+
+    ThreadPool thread_pool(threads);
+    std::vector<NamedKeyframeTrack> reduced;
+    ReductionStats stats = ReduceKeyframes(tracks, tolerance, reduced,
+                                           &thread_pool);
+    if(!KeyframeFile::Write(output, reduced)){
+        std::printf("Could not write %s\n", output.c_str());
+        return 1;
+    }
+
+    double ratio = stats.reduced_keys > 0
+                   ? (double)stats.source_keys / (double)stats.reduced_keys
+                   : 0.0;
+    std::printf("%zu tracks, %zu -> %zu keys, %.2fx fewer\n", tracks.size(),
+                stats.source_keys, stats.reduced_keys, ratio);
+    std::printf("Max error: position %g, angle %g degrees\n",
+                stats.position_error, stats.angle_error_degrees);
+    return 0;
+}